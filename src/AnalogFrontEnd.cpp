@@ -0,0 +1,114 @@
+#include "AnalogFrontEnd.h"
+
+AnalogFrontEnd::AnalogFrontEnd(uint8_t oversampleBits): _oversampleBits(min(oversampleBits, (uint8_t) ANALOG_FRONT_END_MAX_OVERSAMPLE_BITS)) {
+  _createLock();
+}
+
+AnalogFrontEnd::~AnalogFrontEnd() {
+  if (_lock != NULL) {
+    vSemaphoreDelete(_lock);
+    _lock = NULL;
+  }
+}
+
+void AnalogFrontEnd::_buildLinearTable() {
+  esp_adc_cal_characteristics_t characteristics;
+  esp_adc_cal_value_t source = esp_adc_cal_characterize(ADC_UNIT_1, ANALOG_FRONT_END_ATTENUATION, ANALOG_FRONT_END_WIDTH, ANALOG_FRONT_END_DEFAULT_VREF, &characteristics);
+
+  uint32_t minMillivolts = esp_adc_cal_raw_to_voltage(0, &characteristics);
+  uint32_t maxMillivolts = esp_adc_cal_raw_to_voltage(ANALOG_FRONT_END_RAW_VALUES - 1, &characteristics);
+  uint32_t range = max(maxMillivolts - minMillivolts, (uint32_t) 1);
+
+  // The calibration curve is too slow to evaluate per sample so it is flattened into a table once
+  for (uint16_t raw = 0; raw < ANALOG_FRONT_END_RAW_VALUES; raw++) {
+    uint32_t millivolts = esp_adc_cal_raw_to_voltage(raw, &characteristics);
+    uint32_t offset = (millivolts > minMillivolts) ? millivolts - minMillivolts : 0;
+
+    _linearTable[raw] = (uint16_t) min((offset * UINT16_MAX) / range, (uint32_t) UINT16_MAX);
+  }
+
+  log_i("ADC calibration from source %d: %u-%u mV", source, minMillivolts, maxMillivolts);
+}
+
+void AnalogFrontEnd::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
+  }
+}
+
+int8_t AnalogFrontEnd::_getChannel(uint8_t pin) {
+  int8_t channel = digitalPinToAnalogChannel(pin);
+
+  // ADC2 is shared with the WiFi radio so only ADC1 pins are supported
+  if (channel < 0 || channel >= ADC1_CHANNEL_MAX) {
+    return -1;
+  }
+
+  return channel;
+}
+
+bool AnalogFrontEnd::attach(uint8_t pin) {
+  int8_t channel = _getChannel(pin);
+
+  if (channel < 0) {
+    log_e("Pin %d is not an ADC1 pin", pin);
+    return false;
+  }
+
+  return adc1_config_channel_atten((adc1_channel_t) channel, ANALOG_FRONT_END_ATTENUATION) == ESP_OK;
+}
+
+void AnalogFrontEnd::begin() {
+  if (_begun) {
+    return;
+  }
+
+  adc1_config_width(ANALOG_FRONT_END_WIDTH);
+  _buildLinearTable();
+
+  _begun = true;
+}
+
+AnalogFrontEndStats AnalogFrontEnd::getStats() {
+  LockGuard lock (_lock);
+  return _stats;
+}
+
+uint16_t AnalogFrontEnd::read(uint8_t pin) {
+  int8_t channel = _getChannel(pin);
+
+  if (!_begun || channel < 0) {
+    return 0;
+  }
+
+  uint16_t sampleCount = 1 << _oversampleBits;
+  uint32_t sum = 0;
+
+  // One burst per read keeps the channel from being switched mid-sample by another input's task
+  LockGuard lock (_lock);
+
+  uint32_t startTime = micros();
+
+  for (uint16_t i = 0; i < sampleCount; i++) {
+    sum += _linearTable[adc1_get_raw((adc1_channel_t) channel) & (ANALOG_FRONT_END_RAW_VALUES - 1)];
+  }
+
+  uint32_t burstMicros = micros() - startTime;
+
+  _stats.bursts++;
+  _stats.maxBurstMicros = max(_stats.maxBurstMicros, burstMicros);
+  _stats.samples += sampleCount;
+  _stats.totalBurstMicros += burstMicros;
+
+  return (uint16_t) (sum >> _oversampleBits);
+}
+
+void AnalogFrontEnd::resetStats() {
+  LockGuard lock (_lock);
+  _stats = {};
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef EMILYS_NEOPIXEL_ANALOG_FRONT_END_H
+#define EMILYS_NEOPIXEL_ANALOG_FRONT_END_H
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+#include "LockGuard.h"
+
+#define ANALOG_FRONT_END_DEFAULT_OVERSAMPLE_BITS 4
+#define ANALOG_FRONT_END_DEFAULT_VREF 1100
+#define ANALOG_FRONT_END_MAX_OVERSAMPLE_BITS 8
+
+#define ANALOG_FRONT_END_ATTENUATION ADC_ATTEN_DB_11
+#define ANALOG_FRONT_END_RAW_VALUES 4096
+#define ANALOG_FRONT_END_WIDTH ADC_WIDTH_BIT_12
+
+// Noise left after oversampling, in the 16 bit output range
+#define ANALOG_FRONT_END_NOISE_BAND 96
+
+struct AnalogFrontEndStats {
+  uint32_t bursts;
+  uint32_t maxBurstMicros;
+  uint64_t samples;
+  uint64_t totalBurstMicros;
+};
+
+// Reads ADC1 pins at 12 bits, linearized through a calibration table and oversampled to a 16 bit value
+class AnalogFrontEnd {
+  public:
+    AnalogFrontEnd(uint8_t oversampleBits = ANALOG_FRONT_END_DEFAULT_OVERSAMPLE_BITS);
+    ~AnalogFrontEnd();
+
+    bool attach(uint8_t pin);
+    void begin();
+    AnalogFrontEndStats getStats();
+    uint16_t read(uint8_t pin);
+    void resetStats();
+
+  private:
+    uint8_t _oversampleBits;
+
+    bool _begun = false;
+    uint16_t _linearTable[ANALOG_FRONT_END_RAW_VALUES];
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
+    AnalogFrontEndStats _stats = {};
+
+    void _buildLinearTable();
+    void _createLock();
+    static int8_t _getChannel(uint8_t pin);
+};
+#endif
\ No newline at end of file
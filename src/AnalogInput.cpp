@@ -1,18 +1,12 @@
 #include "AnalogInput.h"
 
 AnalogInput::AnalogInput(uint8_t pin): _pin(pin) {
+  _createLock();
+
   _currentRawValue = _getRawValue();
   _currentValue = _currentRawValue;
   _lastRawValue = _currentRawValue;
   _lastValue = _currentRawValue;
-
-  if(_lock == NULL) {
-    _lock = xSemaphoreCreateMutex();
-    if(_lock == NULL) {
-      log_e("xSemaphoreCreateMutex failed");
-      return;
-    }
-  }
 }
 
 AnalogInput::~AnalogInput() {
@@ -20,28 +14,43 @@ AnalogInput::~AnalogInput() {
 
   if (_lock != NULL) {
     vSemaphoreDelete(_lock);
+    _lock = NULL;
   }
 }
 
 void AnalogInput::_createInputTask() {
-    xTaskCreateUniversal(_inputTaskCode, "analog_input_task", ANALOG_INPUT_TASK_STACK_SIZE, this, ANALOG_INPUT_TASK_PRIORITY, &_inputTask, ANALOG_INPUT_TASK_CORE);
+    _inputTask = xTaskCreateStaticPinnedToCore(_inputTaskCode, "analog_input_task", ANALOG_INPUT_TASK_STACK_SIZE, this, _taskPriority, _inputTaskStack, &_inputTaskBuffer, _taskCore);
     if (_inputTask == NULL) {
         log_e(" -- Error creating input task");
     }
 }
 
+void AnalogInput::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
+  }
+}
+
 bool AnalogInput::_debounceInput() {
   LockGuard lock (_lock);
 
   _currentRawValue = _getRawValue();
 
-  if (_currentRawValue == _lastRawValue && (abs(_currentRawValue - _currentValue) > 1)) {
-    if (millis() - _lastChangeTime >= _debounceWindow) {
+  uint16_t drift = abs(_currentRawValue - _lastRawValue);
+  uint16_t change = abs(_currentRawValue - _currentValue);
+
+  if (drift <= _noiseBand && change > _noiseBand + 1) {
+    if (_clock->getMillis() - _lastChangeTime >= _debounceWindow) {
       _currentValue = _currentRawValue;
       return true;
     }
   } else {
-    _lastChangeTime = millis();
+    _lastChangeTime = _clock->getMillis();
     _lastRawValue = _currentRawValue;
   }
 
@@ -56,6 +65,10 @@ void AnalogInput::_deleteInputTask() {
 }
 
 uint16_t AnalogInput::_getRawValue() {
+  if (_frontEnd != NULL) {
+    return _frontEnd->read(_pin);
+  }
+
   uint16_t currentRawValue = analogRead(_pin);
   return currentRawValue;
 }
@@ -97,6 +110,17 @@ void AnalogInput::_raiseOnEvent(uint16_t value) {
 void AnalogInput::begin() {
   pinMode(_pin, INPUT);
 
+  if (_frontEnd != NULL) {
+    _frontEnd->begin();
+    _frontEnd->attach(_pin);
+
+    // The values read by the constructor were at a different resolution
+    _currentRawValue = _getRawValue();
+    _currentValue = _currentRawValue;
+    _lastRawValue = _currentRawValue;
+    _lastValue = _currentRawValue;
+  }
+
   if (_inputTask == NULL) {
     _createInputTask();
   }
@@ -106,6 +130,16 @@ void AnalogInput::end() {
   _deleteInputTask();
 }
 
+UBaseType_t AnalogInput::getStackHighWaterMark() {
+  TaskHandle_t task = _inputTask;
+
+  if (task == NULL) {
+    return 0;
+  }
+
+  return uxTaskGetStackHighWaterMark(task);
+}
+
 uint16_t AnalogInput::getValue() {
   return _currentValue;
 }
@@ -115,6 +149,20 @@ void AnalogInput::onEvent(AnalogInputEventHandler callback) {
   _eventHandler = callback;
 }
 
+void AnalogInput::setClock(Clock& clock) {
+  _clock = &clock;
+}
+
 void AnalogInput::setDebounce(uint16_t debounceWindow) {
   _debounceWindow = debounceWindow;
+}
+
+void AnalogInput::setFrontEnd(AnalogFrontEnd& frontEnd) {
+  _frontEnd = &frontEnd;
+  _noiseBand = ANALOG_FRONT_END_NOISE_BAND;
+}
+
+void AnalogInput::setTaskSchedule(const TaskSchedule& schedule) {
+  _taskCore = schedule.core;
+  _taskPriority = schedule.priority;
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 #define EMILYS_NEOPIXEL_ANALOG_INPUT_H
 
 #include <Arduino.h>
+#include "AnalogFrontEnd.h"
+#include "Clock.h"
+#include "Delegate.h"
 #include "LockGuard.h"
+#include "SchedulingProfile.h"
 
 #define ANALOG_INPUT_DEFAULT_DEBOUNCE_WINDOW 10
 
@@ -10,7 +14,7 @@
 #define ANALOG_INPUT_TASK_PRIORITY (configMAX_PRIORITIES-1)
 #define ANALOG_INPUT_TASK_STACK_SIZE 2048
 
-typedef std::function<void(uint16_t)> AnalogInputEventHandler;
+typedef Delegate<void(uint16_t)> AnalogInputEventHandler;
 
 class AnalogInput {
   public:
@@ -19,14 +23,21 @@ class AnalogInput {
 
     void begin();
     void end();
+    UBaseType_t getStackHighWaterMark();
     uint16_t getValue();
     void onEvent(AnalogInputEventHandler callback);
+    void setClock(Clock& clock);
     void setDebounce(uint16_t debounceWindow = ANALOG_INPUT_DEFAULT_DEBOUNCE_WINDOW);
+    void setFrontEnd(AnalogFrontEnd& frontEnd);
+    void setTaskSchedule(const TaskSchedule& schedule);
 
   protected:
     uint8_t _pin;
 
+    Clock* _clock = &Clock::getSystemClock();
     uint16_t _debounceWindow = 0;
+    AnalogFrontEnd* _frontEnd = NULL;
+    uint16_t _noiseBand = 0;
 
     uint16_t _currentRawValue;
     uint16_t _currentValue;
@@ -35,10 +46,16 @@ class AnalogInput {
     uint16_t _lastValue;
 
     AnalogInputEventHandler _eventHandler;
-    TaskHandle_t _inputTask;
-    SemaphoreHandle_t _lock;
+    TaskHandle_t _inputTask = NULL;
+    StaticTask_t _inputTaskBuffer;
+    StackType_t _inputTaskStack[ANALOG_INPUT_TASK_STACK_SIZE];
+    BaseType_t _taskCore = ANALOG_INPUT_TASK_CORE;
+    UBaseType_t _taskPriority = ANALOG_INPUT_TASK_PRIORITY;
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
 
     void _createInputTask();
+    void _createLock();
     bool _debounceInput();
     void _deleteInputTask();
     uint16_t _getRawValue();
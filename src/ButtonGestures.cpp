@@ -0,0 +1,81 @@
+#include "ButtonGestures.h"
+
+const char* const ButtonGestures::BRIGHTNESS_GESTURES[] = { "S", "L" };
+const char* const ButtonGestures::MODE_GESTURES[] = { "S", "SS", "L" };
+
+ButtonGestures::ButtonGestures(NeoPixel& neoPixel): _neoPixel(neoPixel) {
+
+}
+
+void ButtonGestures::handleBrightnessGesture(GestureEvent event, uint8_t gesture) {
+  // A press held into the sleep timer stepped the brightness when it started, it goes back before the timer starts
+  if (event == GestureEvent::Cancel && gesture == BRIGHTNESS_GESTURE_NEXT) {
+    _neoPixel.setBrightness(_brightnessBeforeNext);
+    return;
+  }
+
+  if (event != GestureEvent::Speculate) {
+    return;
+  }
+
+  if (gesture == BRIGHTNESS_GESTURE_SLEEP_TIMER) {
+    if (_neoPixel.isSleepTimerActive()) {
+      _neoPixel.cancelSleepTimer();
+    } else {
+      _neoPixel.setSleepTimer();
+    }
+    return;
+  }
+
+  _brightnessBeforeNext = _neoPixel.getBrightness();
+  _neoPixel.nextBrightness();
+}
+
+void ButtonGestures::handleModeGesture(GestureEvent event, uint8_t gesture) {
+  // A single press moves on right away, a second press undoes it (restarting a playlist it stopped) and then goes
+  // back one more. A press held into a long one undoes whichever of them it started the same way
+  if (event == GestureEvent::Cancel) {
+    switch (gesture)
+    {
+      case MODE_GESTURE_NEXT: {
+        if (_nextStoppedPlaylist) {
+          _neoPixel.resumePlaylist();
+        } else {
+          _neoPixel.previousMode();
+        }
+        break;
+      }
+      case MODE_GESTURE_PREVIOUS: {
+        if (_previousStoppedPlaylist) {
+          _neoPixel.resumePlaylist();
+        } else {
+          _neoPixel.nextMode();
+        }
+        break;
+      }
+    }
+    return;
+  }
+
+  if (event != GestureEvent::Speculate) {
+    return;
+  }
+
+  switch (gesture)
+  {
+    case MODE_GESTURE_NEXT: {
+      _nextStoppedPlaylist = _neoPixel.isPlaylistActive();
+      _neoPixel.nextMode();
+      break;
+    }
+    case MODE_GESTURE_PREVIOUS: {
+      _previousStoppedPlaylist = _neoPixel.isPlaylistActive();
+      _neoPixel.previousMode();
+      break;
+    }
+    case MODE_GESTURE_PLAYLIST: {
+      _neoPixel.startPlaylist();
+      break;
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef EMILYS_NEOPIXEL_BUTTON_GESTURES_H
+#define EMILYS_NEOPIXEL_BUTTON_GESTURES_H
+
+#include <Arduino.h>
+
+#include "GestureRecognizer.h"
+#include "NeoPixel.h"
+
+#define BRIGHTNESS_GESTURE_COUNT 2
+#define BRIGHTNESS_GESTURE_NEXT 0
+#define BRIGHTNESS_GESTURE_SLEEP_TIMER 1
+
+#define MODE_GESTURE_COUNT 3
+#define MODE_GESTURE_NEXT 0
+#define MODE_GESTURE_PREVIOUS 1
+#define MODE_GESTURE_PLAYLIST 2
+
+// What the brightness and mode buttons' gestures do to the lights. Presses are acted on as soon as they start, so every
+// Speculate that a longer gesture takes over is undone by its Cancel
+class ButtonGestures {
+  public:
+    static const char* const BRIGHTNESS_GESTURES[BRIGHTNESS_GESTURE_COUNT];
+    static const char* const MODE_GESTURES[MODE_GESTURE_COUNT];
+
+    ButtonGestures(NeoPixel& neoPixel);
+
+    void handleBrightnessGesture(GestureEvent event, uint8_t gesture);
+    void handleModeGesture(GestureEvent event, uint8_t gesture);
+
+  private:
+    // Only touched from the buttons' tasks
+    uint8_t _brightnessBeforeNext = 0;
+    NeoPixel& _neoPixel;
+    bool _nextStoppedPlaylist = false;
+    bool _previousStoppedPlaylist = false;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef EMILYS_NEOPIXEL_CLOCK_H
+#define EMILYS_NEOPIXEL_CLOCK_H
+
+#include <Arduino.h>
+
+class Clock {
+  public:
+    virtual ~Clock() {}
+
+    virtual uint32_t getMillis() = 0;
+
+    static Clock& getSystemClock();
+};
+
+class SystemClock final : public Clock {
+  public:
+    uint32_t getMillis() override {
+      return millis();
+    }
+};
+
+class VirtualClock final : public Clock {
+  public:
+    explicit VirtualClock(uint32_t startMillis = 0) : _millis(startMillis) {
+    }
+
+    void advance(uint32_t elapsedMillis) {
+      _millis += elapsedMillis;
+    }
+
+    uint32_t getMillis() override {
+      return _millis;
+    }
+
+    void setMillis(uint32_t currentMillis) {
+      _millis = currentMillis;
+    }
+
+  private:
+    volatile uint32_t _millis;
+};
+
+inline Clock& Clock::getSystemClock() {
+  static SystemClock systemClock;
+  return systemClock;
+}
+#endif
\ No newline at end of file
@@ -24,13 +24,15 @@ void ColorInput::_raiseOnEvent(uint16_t red, uint16_t green, uint16_t blue) {
 }
 
 void ColorInput::begin() {
-  _red.onEvent([this](uint16_t value) -> void { return this->_onInputEvent(value); });
-  _green.onEvent([this](uint16_t value) -> void { return this->_onInputEvent(value); });
-  _blue.onEvent([this](uint16_t value) -> void { return this->_onInputEvent(value); });
+  AnalogInputEventHandler inputEventHandler = AnalogInputEventHandler::bind<ColorInput, &ColorInput::_onInputEvent>(this);
 
   _red.begin();
   _green.begin();
   _blue.begin();
+
+  _red.onEvent(inputEventHandler);
+  _green.onEvent(inputEventHandler);
+  _blue.onEvent(inputEventHandler);
 }
 
 void ColorInput::end() {
@@ -51,6 +53,22 @@ uint16_t ColorInput::getBlueValue() {
   return _blue.getValue();
 }
 
+UBaseType_t ColorInput::getStackHighWaterMark() {
+  return min(_red.getStackHighWaterMark(), min(_green.getStackHighWaterMark(), _blue.getStackHighWaterMark()));
+}
+
 void ColorInput::onEvent(ColorInputEventHandler callback) {
   _eventHandler = callback;
+}
+
+void ColorInput::setFrontEnd(AnalogFrontEnd& frontEnd) {
+  _red.setFrontEnd(frontEnd);
+  _green.setFrontEnd(frontEnd);
+  _blue.setFrontEnd(frontEnd);
+}
+
+void ColorInput::setTaskSchedule(const TaskSchedule& schedule) {
+  _red.setTaskSchedule(schedule);
+  _green.setTaskSchedule(schedule);
+  _blue.setTaskSchedule(schedule);
 }
\ No newline at end of file
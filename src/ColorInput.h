@@ -4,9 +4,10 @@
 #include <Arduino.h>
 
 #include "AnalogInput.h"
+#include "Delegate.h"
 #include "LockGuard.h"
 
-typedef std::function<void(uint16_t, uint16_t, uint16_t)> ColorInputEventHandler;
+typedef Delegate<void(uint16_t, uint16_t, uint16_t)> ColorInputEventHandler;
 
 class ColorInput {
   public:
@@ -18,7 +19,10 @@ class ColorInput {
     uint16_t getRedValue();
     uint16_t getGreenValue();
     uint16_t getBlueValue();
+    UBaseType_t getStackHighWaterMark();
     void onEvent(ColorInputEventHandler callback);
+    void setFrontEnd(AnalogFrontEnd& frontEnd);
+    void setTaskSchedule(const TaskSchedule& schedule);
 
   private:
     AnalogInput _red;
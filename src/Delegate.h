@@ -0,0 +1,57 @@
+#ifndef EMILYS_NEOPIXEL_DELEGATE_H
+#define EMILYS_NEOPIXEL_DELEGATE_H
+
+#include <Arduino.h>
+
+template <typename Signature>
+class Delegate;
+
+// Fixed size, non-allocating replacement for std::function that can hold a free function or a bound member function
+template <typename R, typename... Args>
+class Delegate<R(Args...)> final {
+  public:
+    Delegate() {
+    }
+
+    Delegate(R (*function)(Args...)) : _function(function), _stub(function != NULL ? _functionStub : NULL) {
+    }
+
+    template <typename T, R (T::*Method)(Args...)>
+    static Delegate bind(T* object) {
+      Delegate delegate;
+      delegate._object = object;
+      delegate._stub = _methodStub<T, Method>;
+      return delegate;
+    }
+
+    R operator()(Args... args) const {
+      return _stub(*this, args...);
+    }
+
+    explicit operator bool() const {
+      return _stub != NULL;
+    }
+
+    bool operator==(std::nullptr_t) const {
+      return _stub == NULL;
+    }
+
+    bool operator!=(std::nullptr_t) const {
+      return _stub != NULL;
+    }
+
+  private:
+    R (*_function)(Args...) = NULL;
+    void* _object = NULL;
+    R (*_stub)(const Delegate&, Args...) = NULL;
+
+    static R _functionStub(const Delegate& delegate, Args... args) {
+      return delegate._function(args...);
+    }
+
+    template <typename T, R (T::*Method)(Args...)>
+    static R _methodStub(const Delegate& delegate, Args... args) {
+      return (static_cast<T*>(delegate._object)->*Method)(args...);
+    }
+};
+#endif
\ No newline at end of file
@@ -1,20 +1,14 @@
 #include "DigitalInput.h"
 
 DigitalInput::DigitalInput(uint8_t pin, uint8_t trigger): _pin(pin), _trigger(trigger) {
+  _createLock();
+
   _inverted = (trigger == LOW);
 
   _currentRawState = _getRawState();
   _currentState = _currentRawState;
   _lastRawState = _currentRawState;
   _lastState = _currentRawState;
-
-  if(_lock == NULL) {
-    _lock = xSemaphoreCreateMutex();
-    if(_lock == NULL) {
-      log_e("xSemaphoreCreateMutex failed");
-      return;
-    }
-  }
 }
 
 DigitalInput::~DigitalInput() {
@@ -22,34 +16,110 @@ DigitalInput::~DigitalInput() {
 
   if (_lock != NULL) {
     vSemaphoreDelete(_lock);
+    _lock = NULL;
+  }
+}
+
+void DigitalInput::_createDebounceTimer() {
+  if (_debounceTimer != NULL || _debounceWindow == 0) {
+    return;
+  }
+
+  esp_timer_create_args_t timerArgs = {};
+
+  timerArgs.callback = _onDebounceTimer;
+  timerArgs.arg = this;
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "digital_input_debounce";
+
+  if (esp_timer_create(&timerArgs, &_debounceTimer) != ESP_OK) {
+    _debounceTimer = NULL;
+    log_e("esp_timer_create failed");
   }
 }
 
 void DigitalInput::_createInputTask() {
-    xTaskCreateUniversal(_inputTaskCode, "digital_input_task", DIGITAL_INPUT_TASK_STACK_SIZE, this, DIGITAL_INPUT_TASK_PRIORITY, &_inputTask, DIGITAL_INPUT_TASK_CORE);
+    _inputTask = xTaskCreateStaticPinnedToCore(_inputTaskCode, "digital_input_task", DIGITAL_INPUT_TASK_STACK_SIZE, this, _taskPriority, _inputTaskStack, &_inputTaskBuffer, _taskCore);
     if (_inputTask == NULL) {
         log_e(" -- Error creating input task");
     }
 }
 
+void DigitalInput::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
+  }
+}
+
 bool DigitalInput::_debounceInput() {
   LockGuard lock (_lock);
 
+  // Only the last edge of a burst matters, anything before it was a glitch that never settled
+  uint8_t edgeTail = _edgeTail.load(std::memory_order_relaxed);
+
+  while (edgeTail != _edgeHead.load(std::memory_order_acquire)) {
+    const DigitalInputEdge &edge = _edges[edgeTail];
+
+    if (edge.state != _lastRawState) {
+      // The first edge away from the settled state is when the button was actually pressed or let go
+      if (_lastRawState == _currentState) {
+        _transitionTime = edge.time;
+      }
+
+      _lastChangeTime = edge.time;
+      _lastRawState = edge.state;
+    }
+
+    edgeTail = (edgeTail + 1) % DIGITAL_INPUT_EDGE_BUFFER_SIZE;
+    _edgeTail.store(edgeTail, std::memory_order_release);
+  }
+
+  // Edges dropped while the buffer was full are recovered from the current level
   _currentRawState = _getRawState();
 
-  if (_currentRawState == _lastRawState) {
-    if (millis() - _lastChangeTime >= _debounceWindow) {
-      _currentState = _currentRawState;
-      return true;
+  if (_currentRawState != _lastRawState) {
+    if (_lastRawState == _currentState) {
+      _transitionTime = _clock->getMillis();
     }
-  } else {
-    _lastChangeTime = millis();
+
+    _lastChangeTime = _clock->getMillis();
     _lastRawState = _currentRawState;
   }
 
+  uint32_t sinceLastChange = _clock->getMillis() - _lastChangeTime;
+
+  if (sinceLastChange >= _debounceWindow) {
+    if (_currentState != _currentRawState) {
+      // Time between the transition settling and the task getting to it
+      uint32_t latency = sinceLastChange - _debounceWindow;
+
+      _stats.latencySamples++;
+      _stats.maxLatency = max(_stats.maxLatency, latency);
+      _stats.totalLatency += latency;
+    }
+
+    _currentState = _currentRawState;
+    return true;
+  }
+
   return false;
 }
 
+void DigitalInput::_deleteDebounceTimer() {
+  esp_timer_handle_t debounceTimer = _debounceTimer;
+
+  if (debounceTimer != NULL) {
+    _debounceTimer = NULL;
+    esp_timer_stop(debounceTimer);
+    esp_timer_delete(debounceTimer);
+  }
+}
+
 void DigitalInput::_deleteInputTask() {
   if (_inputTask != NULL) {
     vTaskDelete(_inputTask);
@@ -67,35 +137,60 @@ bool DigitalInput::_getRawState() {
   return currentRawState;
 }
 
+TickType_t DigitalInput::_getTicksToWait() {
+  uint32_t currentTime = _clock->getMillis();
+
+  // A transition still settling is finished by the debounce timer's wakeup, a long trigger cannot be due before it
+  if (_lastRawState != _currentState) {
+    if (_debounceTimer != NULL) {
+      return portMAX_DELAY;
+    }
+
+    uint32_t sinceLastChange = currentTime - _lastChangeTime;
+    return (sinceLastChange >= _debounceWindow) ? 0 : pdMS_TO_TICKS(_debounceWindow - sinceLastChange) + 1;
+  }
+
+  if (_currentState == DIGITAL_INPUT_TRIGGERED && _longTriggerWindow > 0 && _triggerStartTime != 0) {
+    uint32_t sinceTrigger = currentTime - _triggerStartTime;
+    return (sinceTrigger >= _longTriggerWindow) ? 0 : pdMS_TO_TICKS(_longTriggerWindow - sinceTrigger) + 1;
+  }
+
+  return portMAX_DELAY;
+}
+
 void DigitalInput::_handleInput() {
   if (!_debounceInput()) {
     return;
   }
 
   if (_currentState == DIGITAL_INPUT_TRIGGERED && _lastState == DIGITAL_INPUT_TRIGGERED) {
-    if (_longTriggerWindow > 0 && _triggerStartTime != 0 && millis() - _triggerStartTime >= _longTriggerWindow) {
+    if (_longTriggerWindow > 0 && _triggerStartTime != 0 && _clock->getMillis() - _triggerStartTime >= _longTriggerWindow) {
+      _eventTime = _triggerEdgeTime + _longTriggerWindow;
       _raiseOnEvent(DigitalInputEvent::LongTrigger);
       _triggerStartTime = 0;
     }
   } else if (_currentState == DIGITAL_INPUT_TRIGGERED && _lastState == DIGITAL_INPUT_RELEASED) {
+      _eventTime = _transitionTime;
+      _triggerEdgeTime = _transitionTime;
       _raiseOnEvent(DigitalInputEvent::Trigger);
-      _triggerStartTime = millis();
+      _triggerStartTime = _clock->getMillis();
   } else if (_currentState == DIGITAL_INPUT_RELEASED && _lastState == DIGITAL_INPUT_TRIGGERED) {
+      _eventTime = _transitionTime;
       _raiseOnEvent(DigitalInputEvent::Release);
 
       _multiTriggerCount++;
 
       if (_multiTriggerCount == 1) {
-        _multiTriggerStartTime = millis();
+        _multiTriggerStartTime = _clock->getMillis();
       } else {
-        if (_multiTriggerWindow > 0 && millis() - _multiTriggerStartTime <= _multiTriggerWindow) {
+        if (_multiTriggerWindow > 0 && _clock->getMillis() - _multiTriggerStartTime <= _multiTriggerWindow) {
           if (_multiTriggerCount >= _multiTriggerTarget) {
             _raiseOnEvent(DigitalInputEvent::MultiTrigger);
             _multiTriggerCount = 0;
           }
         } else {
           _multiTriggerCount = 1;
-          _multiTriggerStartTime = millis();
+          _multiTriggerStartTime = _clock->getMillis();
         }
       }
   }
@@ -105,25 +200,63 @@ void DigitalInput::_handleInput() {
 
 void DigitalInput::_inputTaskCode(void *args) {
   DigitalInput *digitalInput = (DigitalInput *)args;
-  uint32_t notificationTime = 0;
   uint32_t notificationValue;
-  uint32_t ticksToWait = portMAX_DELAY;
 
   for(;;) {
-    ticksToWait = (millis() - notificationTime) >= DIGITAL_INPUT_NOTIFICATION_WINDOW ? portMAX_DELAY : 1;
-  
-    if (xTaskNotifyWait(0, ULONG_MAX, &notificationValue, ticksToWait) == pdTRUE) {
-      notificationTime = millis();
-    }
-
+    xTaskNotifyWait(0, ULONG_MAX, &notificationValue, digitalInput->_getTicksToWait());
+    digitalInput->_stats.wakeups++;
     digitalInput->_handleInput();
   }
 
   vTaskDelete(NULL);
 }
 
+void DigitalInput::_onDebounceTimer(void *args) {
+  DigitalInput *digitalInput = (DigitalInput *)args;
+  TaskHandle_t inputTask = digitalInput->_inputTask;
+
+  // A glitch that went back to the settled level costs no wakeup, unless the task already saw it start and is
+  // waiting for it to settle
+  bool settled = digitalInput->_getRawState() == digitalInput->_currentState && digitalInput->_lastRawState == digitalInput->_currentState;
+
+  if (inputTask == NULL || settled) {
+    return;
+  }
+
+  xTaskNotify(inputTask, (uint32_t)true, eSetValueWithOverwrite);
+}
+
 void IRAM_ATTR DigitalInput::_onInputChange(void *args) {
   DigitalInput *digitalInput = (DigitalInput *)args;
+  uint8_t edgeHead = digitalInput->_edgeHead.load(std::memory_order_relaxed);
+  uint8_t nextEdgeHead = (edgeHead + 1) % DIGITAL_INPUT_EDGE_BUFFER_SIZE;
+
+  digitalInput->_stats.edges++;
+
+  if (nextEdgeHead == digitalInput->_edgeTail.load(std::memory_order_acquire)) {
+    digitalInput->_stats.droppedEdges++;
+  } else {
+    bool state = digitalRead(digitalInput->_pin);
+
+    // millis() lives in IRAM, a Clock is a virtual call into flash which is not safe while the cache is disabled
+    digitalInput->_edges[edgeHead].time = millis();
+    digitalInput->_edges[edgeHead].state = digitalInput->_inverted ? !state : state;
+    digitalInput->_edgeHead.store(nextEdgeHead);
+  }
+
+  // Bounces only push the deadline back, the task is woken once by the timer after the last of them
+  esp_timer_handle_t debounceTimer = digitalInput->_debounceTimer;
+
+  if (debounceTimer != NULL) {
+    esp_timer_stop(debounceTimer);
+    esp_timer_start_once(debounceTimer, (uint64_t) digitalInput->_debounceWindow * 1000);
+    return;
+  }
+
+  if (digitalInput->_inputTask == NULL) {
+    return;
+  }
+
   BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
   xTaskNotifyFromISR(digitalInput->_inputTask, (uint32_t)true, eSetValueWithOverwrite, &xHigherPriorityTaskWoken);
@@ -133,6 +266,8 @@ void IRAM_ATTR DigitalInput::_onInputChange(void *args) {
 void DigitalInput::_raiseOnEvent(DigitalInputEvent event) {
   DigitalInputEventHandler eventHandler = _eventHandler;
 
+  _stats.events++;
+
   if (eventHandler != NULL) {
     eventHandler(event);
   }
@@ -143,13 +278,34 @@ void DigitalInput::begin() {
     _createInputTask();
   }
 
+  _createDebounceTimer();
+
   attachInterruptArg(_pin, _onInputChange, this, CHANGE);
 }
 
 void DigitalInput::end() {
+  _deleteDebounceTimer();
   _deleteInputTask();
 }
 
+uint32_t DigitalInput::getEventTime() {
+  return _eventTime;
+}
+
+UBaseType_t DigitalInput::getStackHighWaterMark() {
+  TaskHandle_t task = _inputTask;
+
+  if (task == NULL) {
+    return 0;
+  }
+
+  return uxTaskGetStackHighWaterMark(task);
+}
+
+DigitalInputStats DigitalInput::getStats() {
+  return _stats;
+}
+
 bool DigitalInput::isTriggered() {
   return _currentState;
 }
@@ -159,6 +315,14 @@ void DigitalInput::onEvent(DigitalInputEventHandler callback) {
   _eventHandler = callback;
 }
 
+void DigitalInput::resetStats() {
+  _stats = {};
+}
+
+void DigitalInput::setClock(Clock& clock) {
+  _clock = &clock;
+}
+
 void DigitalInput::setDebounce(uint16_t debounceWindow) {
   _debounceWindow = debounceWindow;
 }
@@ -169,4 +333,13 @@ void DigitalInput::setLongTrigger(uint16_t longTriggerWindow) {
 
 void DigitalInput::setMultiTrigger(uint16_t multiTriggerWindow) {
   _multiTriggerWindow = multiTriggerWindow;
+}
+
+void DigitalInput::setMultiTriggerTarget(uint8_t multiTriggerTarget) {
+  _multiTriggerTarget = max(multiTriggerTarget, (uint8_t) 2);
+}
+
+void DigitalInput::setTaskSchedule(const TaskSchedule& schedule) {
+  _taskCore = schedule.core;
+  _taskPriority = schedule.priority;
 }
\ No newline at end of file
@@ -2,13 +2,19 @@
 #define EMILYS_NEOPIXEL_DIGITAL_INPUT_H
 
 #include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+#include "Clock.h"
+#include "Delegate.h"
 #include "LockGuard.h"
+#include "SchedulingProfile.h"
 
 #define DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW 20
 #define DIGITAL_INPUT_DEFAULT_LONG_TRIGGER_WINDOW 150
 #define DIGITAL_INPUT_DEFAULT_MULTI_TRIGGER_WINDOW 400
 
-#define DIGITAL_INPUT_NOTIFICATION_WINDOW 5000
+#define DIGITAL_INPUT_EDGE_BUFFER_SIZE 16
 
 #define DIGITAL_INPUT_TASK_CORE tskNO_AFFINITY
 #define DIGITAL_INPUT_TASK_PRIORITY (configMAX_PRIORITIES-1)
@@ -24,7 +30,23 @@ enum class DigitalInputEvent: uint8_t {
     MultiTrigger = 3
 };
 
-typedef std::function<void(DigitalInputEvent)> DigitalInputEventHandler;
+struct DigitalInputEdge {
+  uint32_t time;
+  bool state;
+};
+
+struct DigitalInputStats {
+  uint32_t droppedEdges;
+  uint32_t edges;
+  uint32_t events;
+  // Settled transitions, the only events with a latency, long triggers come from a timeout
+  uint32_t latencySamples;
+  uint32_t maxLatency;
+  uint32_t totalLatency;
+  uint32_t wakeups;
+};
+
+typedef Delegate<void(DigitalInputEvent)> DigitalInputEventHandler;
 
 class DigitalInput {
   public:
@@ -33,25 +55,39 @@ class DigitalInput {
 
     void begin();
     void end();
+    uint32_t getEventTime();
+    UBaseType_t getStackHighWaterMark();
+    DigitalInputStats getStats();
     bool isTriggered();
     void onEvent(DigitalInputEventHandler callback);
+    void resetStats();
+    void setClock(Clock& clock);
     void setDebounce(uint16_t debounceWindow = DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW);
     void setLongTrigger(uint16_t longTriggerWindow = DIGITAL_INPUT_DEFAULT_LONG_TRIGGER_WINDOW);
     void setMultiTrigger(uint16_t multiTriggerWindow = DIGITAL_INPUT_DEFAULT_MULTI_TRIGGER_WINDOW);
+    void setMultiTriggerTarget(uint8_t multiTriggerTarget);
+    void setTaskSchedule(const TaskSchedule& schedule);
 
   protected:
     bool _inverted;
     uint8_t _pin;
     uint8_t _trigger;
 
+    // Edges are timestamped with millis() in the interrupt, so a clock set here has to follow millis()
+    Clock* _clock = &Clock::getSystemClock();
     uint16_t _debounceWindow = 0;
     uint16_t _longTriggerWindow = 0; 
     uint8_t _multiTriggerTarget = 2;
     uint16_t _multiTriggerWindow = 0;
 
+    // When the last event was due on the raw input, from the first edge of the press or release rather than from
+    // when it settled
+    uint32_t _eventTime = 0;
     uint32_t _lastChangeTime = 0;
     uint8_t _multiTriggerCount = 0;
     uint32_t _multiTriggerStartTime = 0;
+    uint32_t _transitionTime = 0;
+    uint32_t _triggerEdgeTime = 0;
     uint32_t _triggerStartTime = 0;
 
     bool _currentRawState;
@@ -59,16 +95,34 @@ class DigitalInput {
     bool _lastRawState;
     bool _lastState;
 
+    DigitalInputEdge _edges[DIGITAL_INPUT_EDGE_BUFFER_SIZE];
+    // The interrupt and the task can run on different cores, the atomics order the edge writes against the indices
+    std::atomic<uint8_t> _edgeHead { 0 };
+    std::atomic<uint8_t> _edgeTail { 0 };
+    DigitalInputStats _stats = {};
+
+    // Restarted by every edge, so it only runs out once the line has been quiet for the whole debounce window
+    esp_timer_handle_t _debounceTimer = NULL;
     DigitalInputEventHandler _eventHandler;
-    TaskHandle_t _inputTask;
-    SemaphoreHandle_t _lock;
+    TaskHandle_t _inputTask = NULL;
+    StaticTask_t _inputTaskBuffer;
+    StackType_t _inputTaskStack[DIGITAL_INPUT_TASK_STACK_SIZE];
+    BaseType_t _taskCore = DIGITAL_INPUT_TASK_CORE;
+    UBaseType_t _taskPriority = DIGITAL_INPUT_TASK_PRIORITY;
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
 
+    void _createDebounceTimer();
     void _createInputTask();
+    void _createLock();
     bool _debounceInput();
+    void _deleteDebounceTimer();
     void _deleteInputTask();
     bool _getRawState();
+    TickType_t _getTicksToWait();
     void _handleInput();
     static void _inputTaskCode(void *args);
+    static void _onDebounceTimer(void *args);
     static void IRAM_ATTR _onInputChange(void *args);
     void _raiseOnEvent(DigitalInputEvent event);
 };
@@ -0,0 +1,268 @@
+#include "DigitalInputBank.h"
+
+DigitalInputBank::DigitalInputBank() {
+  memset(_slots, 0, sizeof(_slots));
+  _createLock();
+}
+
+DigitalInputBank::~DigitalInputBank() {
+  end();
+
+  if (_lock != NULL) {
+    vSemaphoreDelete(_lock);
+    _lock = NULL;
+  }
+}
+
+void DigitalInputBank::_createInputTask() {
+    _inputTask = xTaskCreateStaticPinnedToCore(_inputTaskCode, "digital_input_bank_task", DIGITAL_INPUT_BANK_TASK_STACK_SIZE, this, _taskPriority, _inputTaskStack, &_inputTaskBuffer, _taskCore);
+    if (_inputTask == NULL) {
+        log_e(" -- Error creating input task");
+    }
+}
+
+void DigitalInputBank::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
+  }
+}
+
+void DigitalInputBank::_deleteInputTask() {
+  if (_inputTask != NULL) {
+    vTaskDelete(_inputTask);
+    _inputTask = NULL;
+  }
+}
+
+void DigitalInputBank::_handleRelease(uint8_t pin, uint32_t currentTime) {
+  DigitalInputBankSlot &slot = _slots[pin];
+
+  _raiseOnEvent(pin, DigitalInputEvent::Release);
+
+  slot.multiTriggerCount++;
+
+  if (slot.multiTriggerCount == 1) {
+    slot.multiTriggerStartTime = currentTime;
+  } else {
+    if (slot.multiTriggerWindow > 0 && currentTime - slot.multiTriggerStartTime <= slot.multiTriggerWindow) {
+      if (slot.multiTriggerCount >= slot.multiTriggerTarget) {
+        _raiseOnEvent(pin, DigitalInputEvent::MultiTrigger);
+        slot.multiTriggerCount = 0;
+      }
+    } else {
+      slot.multiTriggerCount = 1;
+      slot.multiTriggerStartTime = currentTime;
+    }
+  }
+}
+
+void DigitalInputBank::_inputTaskCode(void *args) {
+  DigitalInputBank *digitalInputBank = (DigitalInputBank *)args;
+  TickType_t lastWakeTime = xTaskGetTickCount();
+
+  for(;;) {
+    vTaskDelayUntil(&lastWakeTime, max(pdMS_TO_TICKS(digitalInputBank->_tickMillis), (TickType_t) 1));
+    digitalInputBank->update(digitalInputBank->_readLevels());
+  }
+
+  vTaskDelete(NULL);
+}
+
+void DigitalInputBank::_raiseOnEvent(uint8_t pin, DigitalInputEvent event) {
+  DigitalInputBankEventHandler eventHandler = _eventHandler;
+
+  _stats.events++;
+
+  if (eventHandler != NULL) {
+    eventHandler(pin, event);
+  }
+}
+
+uint64_t DigitalInputBank::_readLevels() {
+  uint64_t levels = REG_READ(GPIO_IN_REG);
+
+  // GPIO32-39 live in a second register that is only read when one of them is in the bank
+  if ((_pinMask >> 32) != 0) {
+    levels |= (uint64_t) (REG_READ(GPIO_IN1_REG) & GPIO_IN1_DATA) << 32;
+  }
+
+  return levels;
+}
+
+bool DigitalInputBank::addInput(uint8_t pin, uint8_t trigger) {
+  if (_inputTask != NULL) {
+    log_e("Inputs must be added before begin()");
+    return false;
+  }
+
+  if (pin >= SOC_GPIO_PIN_COUNT) {
+    log_e("Invalid pin: %d", pin);
+    return false;
+  }
+
+  uint64_t bit = 1ULL << pin;
+
+  if ((_pinMask & bit) == 0) {
+    _inputCount++;
+  }
+
+  _pinMask |= bit;
+
+  if (trigger == LOW) {
+    _invertMask |= bit;
+  } else {
+    _invertMask &= ~bit;
+  }
+
+  _slots[pin].multiTriggerTarget = 2;
+
+  return true;
+}
+
+void DigitalInputBank::begin() {
+  for (uint8_t pin = 0; pin < SOC_GPIO_PIN_COUNT; pin++) {
+    if ((_pinMask >> pin) & 1) {
+      pinMode(pin, ((_invertMask >> pin) & 1) ? INPUT_PULLUP : INPUT);
+    }
+  }
+
+  // Start from the current levels so buttons held through boot do not fire a Trigger
+  _state = (_readLevels() ^ _invertMask) & _pinMask;
+
+  if (_inputTask == NULL) {
+    _createInputTask();
+  }
+}
+
+void DigitalInputBank::end() {
+  _deleteInputTask();
+}
+
+uint8_t DigitalInputBank::getInputCount() {
+  return _inputCount;
+}
+
+UBaseType_t DigitalInputBank::getStackHighWaterMark() {
+  TaskHandle_t task = _inputTask;
+
+  if (task == NULL) {
+    return 0;
+  }
+
+  return uxTaskGetStackHighWaterMark(task);
+}
+
+DigitalInputBankStats DigitalInputBank::getStats() {
+  return _stats;
+}
+
+bool DigitalInputBank::isTriggered(uint8_t pin) {
+  if (pin >= SOC_GPIO_PIN_COUNT) {
+    return false;
+  }
+
+  LockGuard lock (_lock);
+  return (_state >> pin) & 1;
+}
+
+void DigitalInputBank::onEvent(DigitalInputBankEventHandler callback) {
+  LockGuard lock (_lock);
+  _eventHandler = callback;
+}
+
+void DigitalInputBank::resetStats() {
+  _stats = {};
+}
+
+void DigitalInputBank::setClock(Clock& clock) {
+  _clock = &clock;
+}
+
+void DigitalInputBank::setLongTrigger(uint8_t pin, uint16_t longTriggerWindow) {
+  if (pin < SOC_GPIO_PIN_COUNT) {
+    _slots[pin].longTriggerWindow = longTriggerWindow;
+  }
+}
+
+void DigitalInputBank::setMultiTrigger(uint8_t pin, uint16_t multiTriggerWindow) {
+  if (pin < SOC_GPIO_PIN_COUNT) {
+    _slots[pin].multiTriggerWindow = multiTriggerWindow;
+  }
+}
+
+void DigitalInputBank::setTaskSchedule(const TaskSchedule& schedule) {
+  _taskCore = schedule.core;
+  _taskPriority = schedule.priority;
+}
+
+void DigitalInputBank::setTick(uint16_t tickMillis) {
+  _tickMillis = tickMillis;
+}
+
+void DigitalInputBank::update(uint64_t levels) {
+  uint32_t startTime = micros();
+  uint32_t currentTime = _clock->getMillis();
+  uint64_t toggled;
+
+  {
+    LockGuard lock (_lock);
+
+    // Every pin that disagrees with its debounced state counts up, any pin that agrees is reset to zero
+    uint64_t delta = ((levels ^ _invertMask) & _pinMask) ^ _state;
+
+    _count1 = (_count1 ^ _count0) & delta;
+    _count0 = ~_count0 & delta;
+
+    // The counters wrap back to zero on the DIGITAL_INPUT_BANK_DEBOUNCE_TICKS-th disagreeing sample
+    toggled = delta & ~(_count0 | _count1);
+    _state ^= toggled;
+  }
+
+  uint64_t triggered = toggled & _state;
+  uint64_t released = toggled & ~_state;
+
+  // Only pins with something to report are visited, the rest of the row costs nothing past the bitwise update
+  while (triggered != 0) {
+    uint8_t pin = __builtin_ctzll(triggered);
+    triggered &= triggered - 1;
+
+    _raiseOnEvent(pin, DigitalInputEvent::Trigger);
+    _slots[pin].triggerStartTime = currentTime;
+
+    if (_slots[pin].longTriggerWindow > 0) {
+      _longTriggerPending |= 1ULL << pin;
+    }
+  }
+
+  _longTriggerPending &= ~released;
+
+  while (released != 0) {
+    uint8_t pin = __builtin_ctzll(released);
+    released &= released - 1;
+
+    _handleRelease(pin, currentTime);
+  }
+
+  uint64_t longTriggerPending = _longTriggerPending;
+
+  while (longTriggerPending != 0) {
+    uint8_t pin = __builtin_ctzll(longTriggerPending);
+    longTriggerPending &= longTriggerPending - 1;
+
+    if (currentTime - _slots[pin].triggerStartTime >= _slots[pin].longTriggerWindow) {
+      _raiseOnEvent(pin, DigitalInputEvent::LongTrigger);
+      _longTriggerPending &= ~(1ULL << pin);
+    }
+  }
+
+  uint32_t tickMicros = micros() - startTime;
+
+  _stats.maxTickMicros = max(_stats.maxTickMicros, tickMicros);
+  _stats.ticks++;
+  _stats.totalTickMicros += tickMicros;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef EMILYS_NEOPIXEL_DIGITAL_INPUT_BANK_H
+#define EMILYS_NEOPIXEL_DIGITAL_INPUT_BANK_H
+
+#include <Arduino.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc_caps.h>
+
+#include "Clock.h"
+#include "Delegate.h"
+#include "DigitalInput.h"
+#include "LockGuard.h"
+#include "SchedulingProfile.h"
+
+// Four unchanged ticks in a row make a transition, 4 x 5ms matches DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW
+#define DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS 5
+#define DIGITAL_INPUT_BANK_DEBOUNCE_TICKS 4
+
+#define DIGITAL_INPUT_BANK_TASK_CORE tskNO_AFFINITY
+#define DIGITAL_INPUT_BANK_TASK_PRIORITY (configMAX_PRIORITIES-1)
+#define DIGITAL_INPUT_BANK_TASK_STACK_SIZE 2048
+
+struct DigitalInputBankSlot {
+  uint16_t longTriggerWindow;
+  uint8_t multiTriggerCount;
+  uint32_t multiTriggerStartTime;
+  uint8_t multiTriggerTarget;
+  uint16_t multiTriggerWindow;
+  uint32_t triggerStartTime;
+};
+
+struct DigitalInputBankStats {
+  uint32_t events;
+  uint32_t maxTickMicros;
+  uint32_t ticks;
+  uint64_t totalTickMicros;
+};
+
+typedef Delegate<void(uint8_t, DigitalInputEvent)> DigitalInputBankEventHandler;
+
+// Debounces a whole row of buttons from one periodic tick, one bit per GPIO, instead of a task and interrupt each
+class DigitalInputBank {
+  public:
+    DigitalInputBank();
+    ~DigitalInputBank();
+
+    bool addInput(uint8_t pin, uint8_t trigger = LOW);
+    void begin();
+    void end();
+    uint8_t getInputCount();
+    UBaseType_t getStackHighWaterMark();
+    DigitalInputBankStats getStats();
+    bool isTriggered(uint8_t pin);
+    void onEvent(DigitalInputBankEventHandler callback);
+    void resetStats();
+    void setClock(Clock& clock);
+    void setLongTrigger(uint8_t pin, uint16_t longTriggerWindow = DIGITAL_INPUT_DEFAULT_LONG_TRIGGER_WINDOW);
+    void setMultiTrigger(uint8_t pin, uint16_t multiTriggerWindow = DIGITAL_INPUT_DEFAULT_MULTI_TRIGGER_WINDOW);
+    void setTaskSchedule(const TaskSchedule& schedule);
+    void setTick(uint16_t tickMillis = DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS);
+    void update(uint64_t levels);
+
+  private:
+    Clock* _clock = &Clock::getSystemClock();
+    uint8_t _inputCount = 0;
+    uint64_t _invertMask = 0;
+    uint64_t _pinMask = 0;
+    DigitalInputBankSlot _slots[SOC_GPIO_PIN_COUNT];
+    uint16_t _tickMillis = DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS;
+
+    // Bit n of each word belongs to GPIO n, _count1:_count0 is a 2 bit counter per pin
+    uint64_t _count0 = 0;
+    uint64_t _count1 = 0;
+    uint64_t _longTriggerPending = 0;
+    uint64_t _state = 0;
+    DigitalInputBankStats _stats = {};
+
+    DigitalInputBankEventHandler _eventHandler;
+    TaskHandle_t _inputTask = NULL;
+    StaticTask_t _inputTaskBuffer;
+    StackType_t _inputTaskStack[DIGITAL_INPUT_BANK_TASK_STACK_SIZE];
+    BaseType_t _taskCore = DIGITAL_INPUT_BANK_TASK_CORE;
+    UBaseType_t _taskPriority = DIGITAL_INPUT_BANK_TASK_PRIORITY;
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
+
+    void _createInputTask();
+    void _createLock();
+    void _deleteInputTask();
+    void _handleRelease(uint8_t pin, uint32_t currentTime);
+    static void _inputTaskCode(void *args);
+    void _raiseOnEvent(uint8_t pin, DigitalInputEvent event);
+    uint64_t _readLevels();
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "FixedMath.h"
+
+static const uint8_t SINE_TABLE[256] = {
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+  176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+  245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+  255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+  245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+  176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+  128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+   79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+   37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+   10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+    0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+   10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+   37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+   79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+static const uint8_t NOISE_PERMUTATION[256] = {
+  233, 254,  66, 183,  15, 211, 234, 222, 119, 187, 176, 159,  19, 134,  17,  36,
+  193,  18, 225, 101, 180, 152,  40, 197,  92, 245,  80,  73, 118,  84, 203, 186,
+   54, 188, 153, 202, 165, 158, 177,  71, 139, 227,  28,  89, 136, 207, 121,  49,
+  249,  91, 157,  38,  13, 235, 238,  87, 217, 250,  12,  50, 221, 123, 239,  39,
+  162,  82,  60,  63, 156, 105, 107,  83, 116,  67, 163,  20,  21, 169,  37, 113,
+   96, 144, 198,  34,  31,  35, 132,  57, 214,  10,   9,  86,   4,  32, 137, 149,
+   23, 230, 168, 160, 220,  29, 102, 191,  76, 143,  42, 148, 147,  79,  69, 232,
+  229, 190, 240,  45, 104, 167, 172,  64, 170, 189,  70, 212,  46, 111,  61,  14,
+  109,  52,  33,  98,   1, 226, 224,  90, 200, 131, 253, 199, 215,  51,   3, 223,
+  181, 146,  43, 154,  78,  11, 244, 208, 125,  94, 236, 133,  41,  27, 130, 204,
+   22,  95, 140,  93,  44, 192, 103,  62, 122,   8, 174, 100, 179, 127, 150,  72,
+   77,  48, 171, 129, 210, 128, 182,  85, 248,  75, 209, 161,  47,  25, 164, 142,
+  106, 218,  74, 117, 246, 206, 173, 241,  88,  59, 141, 247, 112, 231,  56, 135,
+  219, 185, 108,  55, 175, 242,   2, 138, 243,   6,   5, 237,  81,  26, 151,  58,
+  252, 184, 255, 114, 178,   0, 196, 251, 155, 110,  99, 213, 228,   7, 124,  24,
+   53, 201,  97, 166, 120, 115, 194, 126,  30,  65,  16, 195, 205, 216, 145,  68
+};
+
+static uint8_t _hash8(uint8_t x, uint8_t y) {
+  return NOISE_PERMUTATION[(uint8_t) (NOISE_PERMUTATION[x] + y)];
+}
+
+static uint8_t _lerp8(uint8_t a, uint8_t b, uint8_t fraction) {
+  return (b >= a) ? a + scale8(b - a, fraction) : a - scale8(a - b, fraction);
+}
+
+static uint8_t _smooth8(uint8_t fraction) {
+  // 3t^2 - 2t^3 in 8 bit fixed point
+  uint16_t squared = ((uint16_t) fraction * fraction) >> 8;
+  return (uint8_t) ((squared * (768 - 2 * (uint16_t) fraction)) >> 8);
+}
+
+uint8_t cos8(uint8_t theta) {
+  return SINE_TABLE[(uint8_t) (theta + 64)];
+}
+
+uint8_t gamma16(uint16_t value) {
+  uint32_t squared = ((uint32_t) value * value) >> 16;
+
+  return (uint8_t) ((squared * sqrt16(value) + (1 << 15)) >> 16);
+}
+
+uint8_t noise8(uint16_t x, uint16_t y) {
+  uint8_t cellX = x >> 8;
+  uint8_t cellY = y >> 8;
+  uint8_t fractionX = _smooth8(x & 0xFF);
+  uint8_t fractionY = _smooth8(y & 0xFF);
+
+  uint8_t top = _lerp8(_hash8(cellX, cellY), _hash8(cellX + 1, cellY), fractionX);
+  uint8_t bottom = _lerp8(_hash8(cellX, cellY + 1), _hash8(cellX + 1, cellY + 1), fractionX);
+
+  return _lerp8(top, bottom, fractionY);
+}
+
+uint8_t scale8(uint8_t value, uint8_t scale) {
+  return ((uint16_t) value * (1 + (uint16_t) scale)) >> 8;
+}
+
+uint8_t sin8(uint8_t theta) {
+  return SINE_TABLE[theta];
+}
+
+uint8_t sqrt16(uint16_t value) {
+  uint16_t result = 0;
+  uint16_t bit = 1 << 14;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+
+    bit >>= 2;
+  }
+
+  return (uint8_t) result;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef EMILYS_NEOPIXEL_FIXED_MATH_H
+#define EMILYS_NEOPIXEL_FIXED_MATH_H
+
+#include <Arduino.h>
+
+// Angles are 0-255 for a full turn, results are 0-255 centered on 128
+uint8_t cos8(uint8_t theta);
+uint8_t sin8(uint8_t theta);
+
+// Linear 16 bit value in, perceptual 8 bit value out, roughly a 2.5 power curve. Nothing finer than 8 bits survives it
+uint8_t gamma16(uint16_t value);
+
+// Coordinates are 8.8 fixed point with one lattice cell per integer step
+uint8_t noise8(uint16_t x, uint16_t y);
+
+uint8_t scale8(uint8_t value, uint8_t scale);
+uint8_t sqrt16(uint16_t value);
+#endif
\ No newline at end of file
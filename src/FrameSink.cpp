@@ -0,0 +1,86 @@
+#include "FrameSink.h"
+
+FrameSink::FrameSink(Print& output, uint16_t width, uint16_t height, FrameSinkFormat format):
+  _format(format),
+  _height(height),
+  _output(output),
+  _width(width) {
+
+}
+
+uint32_t FrameSink::_updateChecksum(uint32_t checksum, const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    checksum ^= data[i];
+    checksum *= FRAME_SINK_CHECKSUM_PRIME;
+  }
+
+  return checksum;
+}
+
+void FrameSink::_writeBinary(const uint8_t* pixels, uint16_t count) {
+  uint16_t byteCount = count * FRAME_SINK_BYTES_PER_PIXEL;
+  uint8_t header[] = {
+    FRAME_SINK_FRAME_MARKER,
+    (uint8_t) _frameCount, (uint8_t) (_frameCount >> 8), (uint8_t) (_frameCount >> 16), (uint8_t) (_frameCount >> 24),
+    (uint8_t) byteCount, (uint8_t) (byteCount >> 8)
+  };
+
+  _output.write(header, sizeof(header));
+  _output.write(pixels, byteCount);
+}
+
+void FrameSink::_writePpm(const uint8_t* pixels, uint16_t count) {
+  // Concatenated P6 images can be converted straight into an animated GIF (e.g. `convert frames.ppm frames.gif`)
+  _output.printf("P6\n%d %d\n255\n", _width, _height);
+
+  for (uint16_t i = 0; i < count && i < _width * _height; i++) {
+    const uint8_t *pixel = pixels + i * FRAME_SINK_BYTES_PER_PIXEL;
+    uint8_t rgb[] = { pixel[1], pixel[0], pixel[2] };
+
+    _output.write(rgb, sizeof(rgb));
+  }
+}
+
+uint32_t FrameSink::getChecksum() {
+  return _checksum;
+}
+
+uint32_t FrameSink::getFrameCount() {
+  return _frameCount;
+}
+
+uint32_t FrameSink::getLastFrameChecksum() {
+  return _lastFrameChecksum;
+}
+
+void FrameSink::reset() {
+  _checksum = FRAME_SINK_CHECKSUM_OFFSET;
+  _frameCount = 0;
+  _lastFrameChecksum = 0;
+}
+
+void FrameSink::write(const uint8_t* pixels, uint16_t count) {
+  if (pixels == NULL) {
+    return;
+  }
+
+  // Pixels are stored GRB, as sent on the wire
+  switch (_format)
+  {
+    case FrameSinkFormat::Ppm: {
+      _writePpm(pixels, count);
+      break;
+    }
+    case FrameSinkFormat::Checksum: {
+      break;
+    }
+    default: {
+      _writeBinary(pixels, count);
+      break;
+    }
+  }
+
+  _lastFrameChecksum = _updateChecksum(FRAME_SINK_CHECKSUM_OFFSET, pixels, count * FRAME_SINK_BYTES_PER_PIXEL);
+  _checksum = _updateChecksum(_checksum, pixels, count * FRAME_SINK_BYTES_PER_PIXEL);
+  _frameCount++;
+}
\ No newline at end of file
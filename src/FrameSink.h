@@ -0,0 +1,47 @@
+#ifndef EMILYS_NEOPIXEL_FRAME_SINK_H
+#define EMILYS_NEOPIXEL_FRAME_SINK_H
+
+#include <Arduino.h>
+
+#define FRAME_SINK_BYTES_PER_PIXEL 3
+#define FRAME_SINK_CHECKSUM_OFFSET 2166136261UL
+#define FRAME_SINK_CHECKSUM_PRIME 16777619UL
+#define FRAME_SINK_FRAME_MARKER 0xF5
+
+// What captures are rendered with, so a capture from the device can be checked against the host goldens
+#define FRAME_SINK_BRIGHTNESS 255
+#define FRAME_SINK_BLUE 64
+#define FRAME_SINK_GREEN 128
+#define FRAME_SINK_RED 255
+
+// Checksum writes nothing at all, so frames are only limited by how fast they render
+enum class FrameSinkFormat: uint8_t {
+    Binary = 0,
+    Ppm = 1,
+    Checksum = 2
+};
+
+class FrameSink {
+  public:
+    FrameSink(Print& output, uint16_t width, uint16_t height, FrameSinkFormat format = FrameSinkFormat::Binary);
+
+    uint32_t getChecksum();
+    uint32_t getFrameCount();
+    uint32_t getLastFrameChecksum();
+    void reset();
+    void write(const uint8_t* pixels, uint16_t count);
+
+  private:
+    uint32_t _checksum = FRAME_SINK_CHECKSUM_OFFSET;
+    FrameSinkFormat _format;
+    uint32_t _frameCount = 0;
+    uint16_t _height;
+    uint32_t _lastFrameChecksum = 0;
+    Print& _output;
+    uint16_t _width;
+
+    static uint32_t _updateChecksum(uint32_t checksum, const uint8_t* data, size_t length);
+    void _writeBinary(const uint8_t* pixels, uint16_t count);
+    void _writePpm(const uint8_t* pixels, uint16_t count);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "GestureRecognizer.h"
+
+GestureRecognizer::GestureRecognizer(const char* const gestures[], uint8_t gestureCount) {
+  _createLock();
+
+  for (uint8_t i = 0; i < GESTURE_RECOGNIZER_MAX_STATES; i++) {
+    _states[i].gesture = GESTURE_RECOGNIZER_NONE;
+    _states[i].next[(uint8_t) GesturePress::Short] = GESTURE_RECOGNIZER_NONE;
+    _states[i].next[(uint8_t) GesturePress::Long] = GESTURE_RECOGNIZER_NONE;
+  }
+
+  if (gestureCount > GESTURE_RECOGNIZER_MAX_GESTURES) {
+    log_e("Too many gestures: %d", gestureCount);
+    gestureCount = GESTURE_RECOGNIZER_MAX_GESTURES;
+  }
+
+  for (uint8_t i = 0; i < gestureCount; i++) {
+    if (!_compile(gestures[i], i)) {
+      log_e("Error compiling gesture %d: %s", i, gestures[i]);
+    }
+  }
+}
+
+GestureRecognizer::~GestureRecognizer() {
+  if (_lock != NULL) {
+    vSemaphoreDelete(_lock);
+    _lock = NULL;
+  }
+}
+
+void GestureRecognizer::_advance(GesturePress press) {
+  int8_t next = _states[_currentState].next[(uint8_t) press];
+
+  if (next == GESTURE_RECOGNIZER_NONE) {
+    // No gesture continues this way, settle what we have and start over from this press
+    _confirm();
+    next = _states[0].next[(uint8_t) press];
+
+    if (next == GESTURE_RECOGNIZER_NONE) {
+      return;
+    }
+  }
+
+  _currentState = next;
+
+  int8_t gesture = _states[next].gesture;
+
+  if (gesture == GESTURE_RECOGNIZER_NONE) {
+    return;
+  }
+
+  // A longer gesture completed so the shorter one that was acted on is rolled back
+  if (_speculatedGesture != GESTURE_RECOGNIZER_NONE) {
+    _stats.cancellations++;
+    _raiseOnEvent(GestureEvent::Cancel, _speculatedGesture);
+  }
+
+  _stats.speculations++;
+  _speculatedGesture = gesture;
+  _raiseOnEvent(GestureEvent::Speculate, gesture);
+
+  // Nothing can follow so there is nothing to wait for, once the press is known to be what it was taken for
+  if (_isFinal(next) && !_shortPending) {
+    _confirm();
+  }
+}
+
+bool GestureRecognizer::_compile(const char* sequence, uint8_t gesture) {
+  uint8_t state = 0;
+
+  if (sequence == NULL || *sequence == '\0') {
+    return false;
+  }
+
+  // Gestures sharing a prefix share states, so the table is a trie over the two kinds of press
+  for (const char* c = sequence; *c != '\0'; c++) {
+    uint8_t press;
+
+    if (*c == GESTURE_RECOGNIZER_SHORT_PRESS) {
+      press = (uint8_t) GesturePress::Short;
+    } else if (*c == GESTURE_RECOGNIZER_LONG_PRESS) {
+      press = (uint8_t) GesturePress::Long;
+    } else {
+      return false;
+    }
+
+    if (_states[state].next[press] == GESTURE_RECOGNIZER_NONE) {
+      if (_stateCount >= GESTURE_RECOGNIZER_MAX_STATES) {
+        return false;
+      }
+
+      _states[state].next[press] = _stateCount++;
+    }
+
+    state = _states[state].next[press];
+  }
+
+  if (_states[state].gesture != GESTURE_RECOGNIZER_NONE) {
+    return false;
+  }
+
+  _states[state].gesture = gesture;
+  return true;
+}
+
+void GestureRecognizer::_confirm() {
+  if (_speculatedGesture != GESTURE_RECOGNIZER_NONE) {
+    // Time from the press that decided it, as it happened on the input, to the gesture being final
+    uint32_t decision = _clock->getMillis() - _lastEventTime;
+
+    _stats.confirmations++;
+    _stats.maxDecisionMillis = max(_stats.maxDecisionMillis, decision);
+    _stats.totalDecisionMillis += decision;
+
+    _raiseOnEvent(GestureEvent::Confirm, _speculatedGesture);
+  }
+
+  _currentState = 0;
+  _speculatedGesture = GESTURE_RECOGNIZER_NONE;
+}
+
+void GestureRecognizer::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
+  }
+}
+
+bool GestureRecognizer::_isFinal(uint8_t state) {
+  return _states[state].next[(uint8_t) GesturePress::Short] == GESTURE_RECOGNIZER_NONE
+    && _states[state].next[(uint8_t) GesturePress::Long] == GESTURE_RECOGNIZER_NONE;
+}
+
+void GestureRecognizer::_onPress(GesturePress press) {
+  _lastInputTime = _clock->getMillis();
+
+  // Debouncing and, for a long press, the long trigger window have already passed by the time the event arrives
+  _lastEventTime = (_input != NULL) ? _input->getEventTime() : _lastInputTime;
+
+  _advance(press);
+}
+
+void GestureRecognizer::_onRelease() {
+  if (!_shortPending) {
+    _onPress(GesturePress::Short);
+    return;
+  }
+
+  // Advanced when the press started, so the decision is still timed from then and only the gap starts now
+  _shortPending = false;
+  _lastInputTime = _clock->getMillis();
+
+  if (_isFinal(_currentState)) {
+    _confirm();
+  }
+}
+
+void GestureRecognizer::_onTrigger() {
+  // A press that could only go on as a long one has to wait to be told which it is
+  if (_states[_currentState].next[(uint8_t) GesturePress::Short] == GESTURE_RECOGNIZER_NONE) {
+    return;
+  }
+
+  _pressGesture = _speculatedGesture;
+  _pressState = _currentState;
+  _shortPending = true;
+
+  _onPress(GesturePress::Short);
+}
+
+void GestureRecognizer::_raiseOnEvent(GestureEvent event, uint8_t gesture) {
+  GestureEventHandler eventHandler = _eventHandler;
+
+  if (eventHandler != NULL) {
+    eventHandler(event, gesture);
+  }
+}
+
+void GestureRecognizer::_undoShortPress() {
+  if (!_shortPending) {
+    return;
+  }
+
+  _shortPending = false;
+
+  // Whatever the press speculated as a short one is cancelled and what it had cancelled is speculated again
+  if (_speculatedGesture != _pressGesture) {
+    _stats.cancellations++;
+    _raiseOnEvent(GestureEvent::Cancel, _speculatedGesture);
+
+    if (_pressGesture != GESTURE_RECOGNIZER_NONE) {
+      _stats.speculations++;
+      _raiseOnEvent(GestureEvent::Speculate, _pressGesture);
+    }
+  }
+
+  _currentState = _pressState;
+  _speculatedGesture = _pressGesture;
+}
+
+void GestureRecognizer::begin() {
+  // Nothing to start, the recognizer runs on its input's task and on loop()
+}
+
+GestureRecognizerStats GestureRecognizer::getStats() {
+  return _stats;
+}
+
+void GestureRecognizer::handleEvent(DigitalInputEvent event) {
+  // Handlers are called with the lock held so Speculate, Cancel and Confirm always arrive in order
+  LockGuard lock (_lock);
+
+  switch (event)
+  {
+    case DigitalInputEvent::Trigger: {
+      _longPress = false;
+      _pressed = true;
+      _onTrigger();
+      break;
+    }
+    case DigitalInputEvent::LongTrigger: {
+      if (_pressed && !_longPress) {
+        _longPress = true;
+        _undoShortPress();
+        _onPress(GesturePress::Long);
+      }
+      break;
+    }
+    case DigitalInputEvent::Release: {
+      if (_pressed && !_longPress) {
+        _onRelease();
+      }
+
+      _pressed = false;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void GestureRecognizer::onEvent(GestureEventHandler callback) {
+  LockGuard lock (_lock);
+  _eventHandler = callback;
+}
+
+void GestureRecognizer::poll() {
+  LockGuard lock (_lock);
+
+  if (_currentState == 0 || _pressed) {
+    return;
+  }
+
+  if (_clock->getMillis() - _lastInputTime >= _gapWindow) {
+    _confirm();
+  }
+}
+
+void GestureRecognizer::resetStats() {
+  _stats = {};
+}
+
+void GestureRecognizer::setClock(Clock& clock) {
+  _clock = &clock;
+}
+
+void GestureRecognizer::setGap(uint16_t gapWindow) {
+  _gapWindow = gapWindow;
+}
+
+void GestureRecognizer::setInput(DigitalInput& input) {
+  _input = &input;
+}
\ No newline at end of file
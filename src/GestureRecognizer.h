@@ -0,0 +1,99 @@
+#ifndef EMILYS_NEOPIXEL_GESTURE_RECOGNIZER_H
+#define EMILYS_NEOPIXEL_GESTURE_RECOGNIZER_H
+
+#include <Arduino.h>
+
+#include "Clock.h"
+#include "Delegate.h"
+#include "DigitalInput.h"
+#include "LockGuard.h"
+
+#define GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW 300
+#define GESTURE_RECOGNIZER_MAX_GESTURES 8
+#define GESTURE_RECOGNIZER_MAX_STATES 16
+#define GESTURE_RECOGNIZER_NONE -1
+
+#define GESTURE_RECOGNIZER_LONG_PRESS 'L'
+#define GESTURE_RECOGNIZER_SHORT_PRESS 'S'
+
+// Every gesture gets exactly one Speculate followed by either Cancel or Confirm
+enum class GestureEvent: uint8_t {
+    Speculate = 0,
+    Cancel = 1,
+    Confirm = 2
+};
+
+enum class GesturePress: uint8_t {
+    Short = 0,
+    Long = 1
+};
+
+struct GestureState {
+  int8_t gesture;
+  int8_t next[2];
+};
+
+struct GestureRecognizerStats {
+  uint32_t cancellations;
+  uint32_t confirmations;
+  uint32_t maxDecisionMillis;
+  uint32_t speculations;
+  uint32_t totalDecisionMillis;
+};
+
+typedef Delegate<void(GestureEvent, uint8_t)> GestureEventHandler;
+
+// Gestures are strings of presses like "S", "SS" or "SL", compiled into a DFA over short and long presses. A press is
+// taken to be short as soon as it starts and rolled back if the long trigger turns it into a long one
+class GestureRecognizer {
+  public:
+    GestureRecognizer(const char* const gestures[], uint8_t gestureCount);
+    ~GestureRecognizer();
+
+    void begin();
+    GestureRecognizerStats getStats();
+    void handleEvent(DigitalInputEvent event);
+    void onEvent(GestureEventHandler callback);
+    void poll();
+    void resetStats();
+    void setClock(Clock& clock);
+    void setGap(uint16_t gapWindow = GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW);
+    void setInput(DigitalInput& input);
+
+  private:
+    Clock* _clock = &Clock::getSystemClock();
+    uint16_t _gapWindow = GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW;
+    DigitalInput* _input = NULL;
+    GestureState _states[GESTURE_RECOGNIZER_MAX_STATES];
+    uint8_t _stateCount = 1;
+
+    uint8_t _currentState = 0;
+    uint32_t _lastEventTime = 0;
+    uint32_t _lastInputTime = 0;
+    bool _longPress = false;
+    bool _pressed = false;
+    int8_t _speculatedGesture = GESTURE_RECOGNIZER_NONE;
+
+    // Where the recognizer was before a press it took for a short one as it started, put back if the press turns out
+    // to be long
+    int8_t _pressGesture = GESTURE_RECOGNIZER_NONE;
+    uint8_t _pressState = 0;
+    bool _shortPending = false;
+    GestureRecognizerStats _stats = {};
+
+    GestureEventHandler _eventHandler;
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
+
+    void _advance(GesturePress press);
+    bool _compile(const char* sequence, uint8_t gesture);
+    void _confirm();
+    void _createLock();
+    bool _isFinal(uint8_t state);
+    void _onPress(GesturePress press);
+    void _onRelease();
+    void _onTrigger();
+    void _raiseOnEvent(GestureEvent event, uint8_t gesture);
+    void _undoShortPress();
+};
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 
+// Every owner creates its mutex from static storage in its constructor, which needs neither the heap nor a running
+// scheduler, so any method can take the lock before begin()
 class LockGuard final {
   public:
     explicit LockGuard(SemaphoreHandle_t& __m) : _mutex(__m) {
@@ -1,17 +1,47 @@
 #include "NeoPixel.h"
 
+static RTC_DATA_ATTR NeoPixelRtcState rtcState;
+
 const char* NeoPixel::BRIGHTNESS_KEY = "brightness";
 const char* NeoPixel::MODE_KEY = "mode";
+const char* NeoPixel::PLAYLIST_ACTIVE_KEY = "playlist_active";
+const char* NeoPixel::PLAYLIST_KEY = "playlist";
+
+const NeoPixelPlaylistEntry NeoPixel::DEFAULT_PLAYLIST[] = {
+  { NeoPixelMode::Solid, 0, 0, 0, 0, NeoPixelTransition::Fade, 600 },
+  { NeoPixelMode::Rainbow, 0, 0, 0, 0, NeoPixelTransition::Fade, 600 },
+  { NeoPixelMode::RainbowWave, 0, 0, 0, 0, NeoPixelTransition::Fade, 600 },
+  { NeoPixelMode::TheaterChaseRainbow, 0, 0, 0, 0, NeoPixelTransition::Fade, 600 }
+};
 
 NeoPixel::NeoPixel(uint8_t pin): 
-  _strip(NEOPIXEL_LED_COUNT, pin, NEO_GRB + NEO_KHZ800) {
+  _strip(NEOPIXEL_LED_COUNT, -1, NEO_GRB + NEO_KHZ800) {
 
-  if(_lock == NULL) {
-    _lock = xSemaphoreCreateMutex();
-    if(_lock == NULL) {
-      log_e("xSemaphoreCreateMutex failed");
-      return;
-    }
+  _createLock();
+  _output.addStrip(pin, NEOPIXEL_LED_COUNT);
+}
+
+NeoPixel::NeoPixel(const uint8_t pins[], uint8_t stripCount): 
+  _strip(NEOPIXEL_LED_COUNT, -1, NEO_GRB + NEO_KHZ800) {
+
+  _createLock();
+
+  if (stripCount == 0) {
+    log_e("No strips given");
+    return;
+  }
+
+  // Extra pins are dropped rather than their pixels, the framebuffer is still split over the strips we can drive
+  if (stripCount > NEOPIXEL_OUTPUT_MAX_STRIPS) {
+    log_e("Too many strips: %d, only the first %d are used", stripCount, NEOPIXEL_OUTPUT_MAX_STRIPS);
+    stripCount = NEOPIXEL_OUTPUT_MAX_STRIPS;
+  }
+
+  // Split the logical framebuffer into one segment per strip with any remainder on the last strip
+  uint16_t segmentCount = NEOPIXEL_LED_COUNT / stripCount;
+
+  for (uint8_t i = 0; i < stripCount; i++) {
+    _output.addStrip(pins[i], (i == stripCount - 1) ? NEOPIXEL_LED_COUNT - segmentCount * i : segmentCount);
   }
 }
 
@@ -20,11 +50,53 @@ NeoPixel::~NeoPixel() {
 
   if (_lock != NULL) {
     vSemaphoreDelete(_lock);
+    _lock = NULL;
+  }
+}
+
+void NeoPixel::_applyPlaylistEntry(uint8_t index) {
+  {
+    LockGuard lock (_lock);
+
+    if (_playlistCount == 0) {
+      return;
+    }
+
+    const NeoPixelPlaylistEntry &entry = _playlist[index % _playlistCount];
+
+    // Playlist switches are not persisted so an unattended lamp does not wear out the flash
+    _mode = entry.mode;
+
+    if (entry.r != 0 || entry.g != 0 || entry.b != 0) {
+      _r = entry.r;
+      _g = entry.g;
+      _b = entry.b;
+    }
+
+    if (entry.brightness != 0) {
+      _brightness = entry.brightness;
+    }
+
+    _playlistEntryTime = _clock->getMillis();
+    _playlistIndex = index % _playlistCount;
+  }
+
+  log_d("Playlist entry: %d", _playlistIndex);
+}
+
+void NeoPixel::_createLock() {
+  if (_lock != NULL) {
+    return;
+  }
+
+  _lock = xSemaphoreCreateMutexStatic(&_lockBuffer);
+  if (_lock == NULL) {
+    log_e("xSemaphoreCreateMutexStatic failed");
   }
 }
 
 void NeoPixel::_createModeTask() {
-    xTaskCreateUniversal(_modeTaskCode, "neopixel_model_task", NEOPIXEL_MODE_TASK_STACK_SIZE, this, NEOPIXEL_MODE_TASK_PRIORITY, &_modeTask, NEOPIXEL_MODE_TASK_CORE);
+    _modeTask = xTaskCreateStaticPinnedToCore(_modeTaskCode, "neopixel_model_task", NEOPIXEL_MODE_TASK_STACK_SIZE, this, _taskPriority, _modeTaskStack, &_modeTaskBuffer, _taskCore);
     if (_modeTask == NULL) {
         log_e(" -- Error creating mode task");
     }
@@ -37,11 +109,96 @@ void NeoPixel::_deleteModeTask() {
   }
 }
 
-TickType_t NeoPixel::_getTicksToWait() {
-  uint32_t stepMillis = _getStepMillis();
-  uint32_t sinceLastStep = millis() - _lastStepTime;
+void NeoPixel::_enterDeepSleep() {
+  log_i("Sleep timer expired, entering deep sleep");
+
+  {
+    LockGuard lock (_lock);
+
+    rtcState.b = _b;
+    rtcState.brightness = _brightness;
+    rtcState.currentStep = _currentStep;
+    rtcState.g = _g;
+    rtcState.mode = _mode;
+    memcpy(rtcState.playlist, _playlist, sizeof(rtcState.playlist));
+    rtcState.playlistActive = _playlistActive;
+    rtcState.playlistCount = _playlistCount;
+    rtcState.playlistIndex = _playlistIndex;
+    rtcState.r = _r;
+    rtcState.stepDirection = _stepDirection;
+    rtcState.magic = NEOPIXEL_RTC_STATE_MAGIC;
+  }
+
+  _strip.clear();
+  _show();
+  _output.waitTransmit();
+
+  esp_deep_sleep_start();
+}
+
+uint8_t NeoPixel::_getPlaylistFade() {
+  if (!_playlistActive || _playlistCount == 0) {
+    return 255;
+  }
+
+  const NeoPixelPlaylistEntry &entry = _playlist[_playlistIndex];
+  const NeoPixelPlaylistEntry &nextEntry = _playlist[(_playlistIndex + 1) % _playlistCount];
+  uint32_t duration = entry.duration * 1000UL;
+  uint32_t elapsed = min(_clock->getMillis() - _playlistEntryTime, duration);
+  uint32_t fadeMillis = min((uint32_t) NEOPIXEL_PLAYLIST_FADE_MILLIS, duration / 2);
+  uint32_t fade = 255;
+
+  if (fadeMillis == 0) {
+    return 255;
+  }
+
+  // Fade in at the start of an entry and out at the end when the next entry fades in
+  if (entry.transition == NeoPixelTransition::Fade && elapsed < fadeMillis) {
+    fade = elapsed * 255 / fadeMillis;
+  }
+
+  if (nextEntry.transition == NeoPixelTransition::Fade && duration - elapsed < fadeMillis) {
+    fade = min(fade, (duration - elapsed) * 255 / fadeMillis);
+  }
+
+  return (uint8_t) fade;
+}
+
+uint32_t NeoPixel::_getPlaylistWaitMillis() {
+  if (!_playlistActive || _playlistCount == 0) {
+    return UINT32_MAX;
+  }
+
+  if (_getPlaylistFade() < 255) {
+    return NEOPIXEL_PLAYLIST_FADE_STEP_MILLIS;
+  }
+
+  const NeoPixelPlaylistEntry &nextEntry = _playlist[(_playlistIndex + 1) % _playlistCount];
+  uint32_t duration = _playlist[_playlistIndex].duration * 1000UL;
+  uint32_t elapsed = _clock->getMillis() - _playlistEntryTime;
+  uint32_t fadeMillis = (nextEntry.transition == NeoPixelTransition::Fade) ? min((uint32_t) NEOPIXEL_PLAYLIST_FADE_MILLIS, duration / 2) : 0;
+
+  // Wake up exactly when the fade out (or the switch) is due instead of polling
+  return (elapsed + fadeMillis >= duration) ? 0 : duration - fadeMillis - elapsed;
+}
+
+uint8_t NeoPixel::_getSleepFade() {
+  if (!_sleepTimerActive || _sleepTimerMillis == 0) {
+    return 255;
+  }
+
+  uint32_t elapsed = min(_clock->getMillis() - _sleepTimerStartTime, _sleepTimerMillis);
+
+  return (uint8_t) (((uint64_t) (_sleepTimerMillis - elapsed) * 255) / _sleepTimerMillis);
+}
 
-  return (sinceLastStep > stepMillis) ? 1 : pdMS_TO_TICKS(stepMillis - sinceLastStep);
+uint32_t NeoPixel::_getSleepWaitMillis() {
+  if (!_sleepTimerActive) {
+    return UINT32_MAX;
+  }
+
+  // One brightness level at a time, but never faster than a normal fade step
+  return max(_sleepTimerMillis / 255, (uint32_t) NEOPIXEL_PLAYLIST_FADE_STEP_MILLIS);
 }
 
 uint32_t NeoPixel::_getStepMillis() {
@@ -62,11 +219,26 @@ uint32_t NeoPixel::_getStepMillis() {
       return 70;
     case NeoPixelMode::WipeVertical:
       return 140;
+    case NeoPixelMode::Fire:
+    case NeoPixelMode::Noise:
+    case NeoPixelMode::Plasma:
+    case NeoPixelMode::Ripples:
+      return 30;
     default:
       return 50;
   }
 }
 
+TickType_t NeoPixel::_getTicksToWait() {
+  uint32_t waitMillis = getWaitMillis();
+
+  return (waitMillis == 0) ? 1 : pdMS_TO_TICKS(waitMillis);
+}
+
+uint16_t NeoPixel::_getPixelIndex(uint16_t x, uint16_t y) {
+  return y * NEOPIXEL_LED_COLS + x;
+}
+
 uint32_t NeoPixel::_getWheelColor(uint8_t position) {
   position = 255 - position;
   if (position < 85) {
@@ -80,43 +252,65 @@ uint32_t NeoPixel::_getWheelColor(uint8_t position) {
   return _strip.Color(position * 3, 255 - position * 3, 0);
 }
 
-void NeoPixel::_handleMode() {
-  static uint16_t currentStep = 0;
+void NeoPixel::update() {
   static uint16_t currentSubStep = 0;
-  static uint16_t stepDirection = 1;
   static uint32_t color = 0;
 
+  _handlePlaylist();
+
+  if (_isSleepTimerExpired()) {
+    _enterDeepSleep();
+  }
+
   if (_mode != _lastMode) {
     _strip.clear();
-    _strip.show();
+    _show();
 
-    currentStep = 0;
+    _currentStep = 0;
     currentSubStep = 0;
-    stepDirection = 1;
+    _stepDirection = 1;
 
     _lastMode = _mode;
-    _lastStepTime = millis();
+    _lastStepMicros = micros();
+    _lastStepTime = _clock->getMillis();
   }
 
   color = _strip.Color(_r, _g, _b);
 
-  if (millis() - _lastStepTime >= _getStepMillis()) {
-    _lastStepTime = millis();
-    currentStep += stepDirection;
+  if (_clock->getMillis() - _lastStepTime >= _getStepMillis()) {
+    // How far past its due time each step lands is the frame jitter
+    uint32_t currentMicros = micros();
+    uint32_t sinceLastStepMicros = currentMicros - _lastStepMicros;
+    uint32_t stepMicros = _getStepMillis() * 1000;
+    uint32_t lateMicros = (sinceLastStepMicros > stepMicros) ? sinceLastStepMicros - stepMicros : 0;
+
+    _frameStats.maxLateMicros = max(_frameStats.maxLateMicros, lateMicros);
+    _frameStats.steps++;
+    _frameStats.totalLateMicros += lateMicros;
+
+    _lastStepMicros = currentMicros;
+    _lastStepTime = _clock->getMillis();
+    _currentStep += _stepDirection;
   }
 
+  _frameStats.frames++;
+
+  uint32_t renderStartMicros = micros();
+
   switch (_mode)
   {
     case NeoPixelMode::Off: {
+      // The RMT peripheral stops in light sleep, the cleared frame has to be out first
+      _output.waitTransmit();
       esp_light_sleep_start();
       break;
     }
     case NeoPixelMode::Rainbow: {
-      if (currentStep >= 256) {
-        currentStep = 0;
+      if (_currentStep >= 256) {
+        _currentStep = 0;
       }
 
-      uint32_t firstPixelHue = currentStep * 256;
+      uint32_t firstPixelHue = _currentStep * 256;
 
       for (int i = 0; i < NEOPIXEL_LED_COUNT; i++) {
         uint32_t pixelHue = firstPixelHue + (i * 65536L / NEOPIXEL_LED_COUNT);
@@ -126,19 +320,18 @@ void NeoPixel::_handleMode() {
       break;
     }
     case NeoPixelMode::RainbowWave: {
-      if (currentStep >= 256) {
-        currentStep = 0;
+      if (_currentStep >= 256) {
+        _currentStep = 0;
       }
 
-      uint32_t firstPixelHue = currentStep * 256;
+      uint32_t firstPixelHue = _currentStep * 256;
 
       for (int i = 0; i < NEOPIXEL_LED_COLS; i++) {
         uint32_t pixelHue = firstPixelHue + (i * 65536L / NEOPIXEL_LED_COLS);
 
-        _strip.setPixelColor(i, _strip.gamma32(_strip.ColorHSV(pixelHue)));
-        _strip.setPixelColor(i + NEOPIXEL_LED_COLS, _strip.gamma32(_strip.ColorHSV(pixelHue)));
-        _strip.setPixelColor(i + NEOPIXEL_LED_COLS * 2, _strip.gamma32(_strip.ColorHSV(pixelHue)));
-        _strip.setPixelColor(i + NEOPIXEL_LED_COLS * 3, _strip.gamma32(_strip.ColorHSV(pixelHue)));
+        for (int row = 0; row < NEOPIXEL_LED_ROWS; row++) {
+          _strip.setPixelColor(_getPixelIndex(i, row), _strip.gamma32(_strip.ColorHSV(pixelHue)));
+        }
       }
       
       break;
@@ -148,27 +341,27 @@ void NeoPixel::_handleMode() {
       break;
     }
     case NeoPixelMode::TheaterChase: {
-      if (currentStep >= 3) {
-        currentStep = 0;
+      if (_currentStep >= 3) {
+        _currentStep = 0;
       }
 
       _strip.clear();
 
-      for (int i = currentStep; i < NEOPIXEL_LED_COUNT; i += 3) {
+      for (int i = _currentStep; i < NEOPIXEL_LED_COUNT; i += 3) {
         _strip.setPixelColor(i, color);
       }
       
       break;
     }
     case NeoPixelMode::TheaterChaseRainbow: {
-      if (currentStep >= 256) {
-        currentStep = 0;
+      if (_currentStep >= 256) {
+        _currentStep = 0;
       }
 
       _strip.clear();
 
-      uint8_t firstPixel = currentStep % NEOPIXEL_LED_ROWS;
-      uint32_t firstPixelHue = currentStep * 256;
+      uint8_t firstPixel = _currentStep % NEOPIXEL_LED_ROWS;
+      uint32_t firstPixelHue = _currentStep * 256;
 
       for (int i = firstPixel; i < NEOPIXEL_LED_COUNT; i += 3) {
         uint32_t pixelHue = firstPixelHue + (i * 65536L / NEOPIXEL_LED_COUNT);
@@ -178,27 +371,27 @@ void NeoPixel::_handleMode() {
       break;
     }
     case NeoPixelMode::WipeHorizontal: {
-      if (currentStep >= NEOPIXEL_LED_COLS - 1) {
-        stepDirection = -1;
-      } else if (currentStep <= 0) {
-        stepDirection = 1;
+      if (_currentStep >= NEOPIXEL_LED_COLS - 1) {
+        _stepDirection = -1;
+      } else if (_currentStep <= 0) {
+        _stepDirection = 1;
       }
       
       _strip.fill(color);
-      _strip.setPixelColor(currentStep, 0);
-      _strip.setPixelColor(currentStep + NEOPIXEL_LED_COLS, 0);
-      _strip.setPixelColor(currentStep + NEOPIXEL_LED_COLS * 2, 0);
-      _strip.setPixelColor(currentStep + NEOPIXEL_LED_COLS * 3, 0);
+
+      for (int row = 0; row < NEOPIXEL_LED_ROWS; row++) {
+        _strip.setPixelColor(_getPixelIndex(_currentStep, row), 0);
+      }
       break;
     }
     case NeoPixelMode::WipeVertical: {
-      if (currentStep >= NEOPIXEL_LED_ROWS - 1) {
-        stepDirection = -1;
-      } else if (currentStep <= 0) {
-        stepDirection = 1;
+      if (_currentStep >= NEOPIXEL_LED_ROWS - 1) {
+        _stepDirection = -1;
+      } else if (_currentStep <= 0) {
+        _stepDirection = 1;
       }
       
-      uint16_t firstLed = currentStep * NEOPIXEL_LED_COLS;
+      uint16_t firstLed = _currentStep * NEOPIXEL_LED_COLS;
       uint16_t lastLed = firstLed + NEOPIXEL_LED_COLS - 1;
 
       for(int i = 0; i < NEOPIXEL_LED_COUNT; i++) {
@@ -206,13 +399,53 @@ void NeoPixel::_handleMode() {
       }
       break;
     }
+    case NeoPixelMode::Fire: {
+      _renderShader(&NeoPixel::_shadeFire, _currentStep);
+      break;
+    }
+    case NeoPixelMode::Noise: {
+      _renderShader(&NeoPixel::_shadeNoise, _currentStep);
+      break;
+    }
+    case NeoPixelMode::Plasma: {
+      _renderShader(&NeoPixel::_shadePlasma, _currentStep);
+      break;
+    }
+    case NeoPixelMode::Ripples: {
+      _renderShader(&NeoPixel::_shadeRipples, _currentStep);
+      break;
+    }
     default: {
       break;
     }
   }
 
-  _strip.setBrightness(_brightness);
-  _strip.show();
+  uint32_t renderMicros = micros() - renderStartMicros;
+
+  _frameStats.maxRenderMicros = max(_frameStats.maxRenderMicros, renderMicros);
+  _frameStats.totalRenderMicros += renderMicros;
+
+  _strip.setBrightness((uint32_t) _brightness * _getPlaylistFade() * _getSleepFade() / (255 * 255));
+  _show();
+  _lastFrameMicros = micros();
+  _raiseOnFrame();
+
+  if (_firstFrameMicros == 0) {
+    // esp_timer starts with the app, so this leaves out the ROM and bootloader time between the wake up and app start
+    _firstFrameMicros = (uint32_t) esp_timer_get_time();
+    log_i("First frame %u us after app start", _firstFrameMicros);
+  }
+}
+
+void NeoPixel::_handlePlaylist() {
+  if (!_playlistActive || _playlistCount == 0) {
+    return;
+  }
+
+  // The whole playlist lives in RAM so the next entry is ready the moment the current one ends
+  if (_clock->getMillis() - _playlistEntryTime >= _playlist[_playlistIndex].duration * 1000UL) {
+    _applyPlaylistEntry(_playlistIndex + 1);
+  }
 }
 
 void NeoPixel::_modeTaskCode(void *args) {
@@ -221,12 +454,34 @@ void NeoPixel::_modeTaskCode(void *args) {
 
   for(;;) {
     xTaskNotifyWait(0, ULONG_MAX, &notificationValue, neoPixel->_getTicksToWait() + 1);
-    neoPixel->_handleMode();
+    neoPixel->update();
   }
 
   vTaskDelete(NULL);
 }
 
+bool NeoPixel::_isSleepTimerExpired() {
+  return _sleepTimerActive && _clock->getMillis() - _sleepTimerStartTime >= _sleepTimerMillis;
+}
+
+bool NeoPixel::_isValidPlaylist(const NeoPixelPlaylistEntry entries[], uint8_t count) {
+  if (count > 0 && entries == NULL) {
+    return false;
+  }
+
+  // An unknown mode would render garbage and a zero duration would switch entries on every frame
+  for (uint8_t i = 0; i < count; i++) {
+    const NeoPixelPlaylistEntry &entry = entries[i];
+
+    if ((uint8_t) entry.mode > NEOPIXEL_MAX_MODE || (uint8_t) entry.transition > (uint8_t) NeoPixelTransition::Fade || entry.duration == 0) {
+      log_e("Invalid playlist entry %d: mode %d, transition %d, duration %d", i, (uint8_t) entry.mode, (uint8_t) entry.transition, entry.duration);
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void NeoPixel::_notifyModeTask() {
   TaskHandle_t modeTask = _modeTask;
 
@@ -234,7 +489,58 @@ void NeoPixel::_notifyModeTask() {
     return;
   }
 
-  xTaskNotify(modeTask, (uint32_t) true, eSetValueWithOverwrite);
+  xTaskNotify(modeTask, NEOPIXEL_MODE_UPDATE_NOTIFICATION, eSetBits);
+}
+
+void NeoPixel::_raiseOnFrame() {
+  NeoPixelFrameHandler frameHandler = _frameHandler;
+
+  if (frameHandler != NULL) {
+    frameHandler(_strip.getPixels(), _strip.numPixels());
+  }
+}
+
+void NeoPixel::_renderShader(uint32_t (NeoPixel::*shader)(uint16_t, uint16_t, uint16_t), uint16_t time) {
+  for (uint16_t y = 0; y < NEOPIXEL_LED_ROWS; y++) {
+    for (uint16_t x = 0; x < NEOPIXEL_LED_COLS; x++) {
+      _strip.setPixelColor(_getPixelIndex(x, y), (this->*shader)(x, y, time));
+    }
+  }
+}
+
+bool NeoPixel::_restoreRtcState() {
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_EXT0 || rtcState.magic != NEOPIXEL_RTC_STATE_MAGIC) {
+    return false;
+  }
+
+  // Only good for the wake up straight after the sleep timer, a later reset starts from NVS again
+  rtcState.magic = 0;
+
+  if (rtcState.playlistCount > NEOPIXEL_PLAYLIST_MAX_ENTRIES || !_isValidPlaylist(rtcState.playlist, rtcState.playlistCount)) {
+    log_e("Invalid playlist in RTC memory, starting from NVS");
+    return false;
+  }
+
+  _b = rtcState.b;
+  _brightness = rtcState.brightness;
+  _currentStep = rtcState.currentStep;
+  _g = rtcState.g;
+  _mode = rtcState.mode;
+  memcpy(_playlist, rtcState.playlist, sizeof(_playlist));
+  _playlistActive = rtcState.playlistActive;
+  _playlistCount = rtcState.playlistCount;
+  _playlistIndex = rtcState.playlistIndex;
+  _r = rtcState.r;
+  _stepDirection = rtcState.stepDirection;
+
+  // Skip the reset update() does on a mode change so the effect picks up where it left off
+  _lastMode = _mode;
+  _lastStepMicros = micros();
+  _lastStepTime = _clock->getMillis();
+
+  log_i("Restored mode %d from RTC memory", _mode);
+
+  return true;
 }
 
 void NeoPixel::_setBrightness(uint16_t brightness, bool update) {
@@ -304,35 +610,202 @@ void NeoPixel::_setMode(NeoPixelMode mode, bool update) {
   }
 }
 
+uint32_t NeoPixel::_shadeFire(uint16_t x, uint16_t y, uint16_t time) {
+  // Noise scrolling upwards, cooled the further it gets from the bottom row
+  uint8_t heat = noise8(x * 96, (y * 96) + (time * 40));
+  uint8_t cooling = (NEOPIXEL_LED_ROWS - 1 - y) * 255 / NEOPIXEL_LED_ROWS;
+
+  heat = (heat > cooling) ? heat - cooling : 0;
+
+  if (heat < 85) {
+    return _strip.Color(heat * 3, 0, 0);
+  }
+
+  if (heat < 170) {
+    return _strip.Color(255, (heat - 85) * 3, 0);
+  }
+
+  return _strip.Color(255, 255, (heat - 170) * 3);
+}
+
+uint32_t NeoPixel::_shadeNoise(uint16_t x, uint16_t y, uint16_t time) {
+  uint8_t value = noise8((x * 64) + (time * 8), (y * 64) + (time * 3));
+
+  return _strip.gamma32(_strip.ColorHSV((uint16_t) value * 512));
+}
+
+uint32_t NeoPixel::_shadePlasma(uint16_t x, uint16_t y, uint16_t time) {
+  // Coordinates normalized to one full turn across the panel so larger panels show the same pattern
+  uint8_t normalizedX = x * 256 / NEOPIXEL_LED_COLS;
+  uint8_t normalizedY = y * 256 / NEOPIXEL_LED_ROWS;
+
+  uint16_t value = sin8(normalizedX + time)
+    + sin8(normalizedY + (time * 2))
+    + sin8(((normalizedX + normalizedY) / 2) + (time * 3))
+    + cos8(sin8(normalizedX / 2 + time) / 2 + normalizedY);
+
+  return _strip.gamma32(_strip.ColorHSV(value * 64));
+}
+
+uint32_t NeoPixel::_shadeRipples(uint16_t x, uint16_t y, uint16_t time) {
+  // Distance from the center in half pixels so even sized panels stay symmetric
+  int16_t deltaX = (int16_t) (x * 2 + 1) - NEOPIXEL_LED_COLS;
+  int16_t deltaY = (int16_t) (y * 2 + 1) - NEOPIXEL_LED_ROWS;
+  uint16_t distance = sqrt16(deltaX * deltaX + deltaY * deltaY) * 512 / max(NEOPIXEL_LED_COLS, NEOPIXEL_LED_ROWS);
+  uint8_t ripple = sin8(distance - (time * 8));
+
+  return _strip.Color(scale8(_r, ripple), scale8(_g, ripple), scale8(_b, ripple));
+}
+
+void NeoPixel::_show() {
+  _output.show(_strip.getPixels());
+}
+
 void NeoPixel::begin() {
   _preferences.begin("emilys_neopixel", false);
 
-  _brightness = _preferences.getUChar(BRIGHTNESS_KEY, NEOPIXEL_BRIGHTNESS_STEP);
-  _mode = (NeoPixelMode) _preferences.getUChar(MODE_KEY, 0);
+  bool restored = _restoreRtcState();
+
+  if (!restored) {
+    _brightness = _preferences.getUChar(BRIGHTNESS_KEY, NEOPIXEL_BRIGHTNESS_STEP);
+    _mode = (NeoPixelMode) _preferences.getUChar(MODE_KEY, 0);
+  }
 
   if (_mode == NeoPixelMode::Off) {
     _mode = (NeoPixelMode) NEOPIXEL_DEFAULT_MODE;
   }
 
+  // A wake up from the sleep timer already has the playlist back from RTC memory
+  if (!restored) {
+    size_t playlistLength = _preferences.getBytesLength(PLAYLIST_KEY);
+
+    _playlistCount = 0;
+
+    if (playlistLength > 0 && playlistLength <= sizeof(_playlist) && playlistLength % sizeof(NeoPixelPlaylistEntry) == 0) {
+      _playlistCount = _preferences.getBytes(PLAYLIST_KEY, _playlist, playlistLength) / sizeof(NeoPixelPlaylistEntry);
+
+      // The stored bytes are only as good as the firmware that wrote them
+      if (!_isValidPlaylist(_playlist, _playlistCount)) {
+        log_e("Invalid stored playlist, using the default playlist");
+        _playlistCount = 0;
+      }
+    }
+  }
+
+  if (_playlistCount == 0) {
+    _playlistCount = sizeof(DEFAULT_PLAYLIST) / sizeof(NeoPixelPlaylistEntry);
+    memcpy(_playlist, DEFAULT_PLAYLIST, sizeof(DEFAULT_PLAYLIST));
+  }
+
+  if (restored) {
+    if (_playlistActive) {
+      _applyPlaylistEntry(_playlistIndex);
+    }
+  } else if (_preferences.getUChar(PLAYLIST_ACTIVE_KEY, 0) != 0) {
+    _playlistActive = true;
+    _applyPlaylistEntry(0);
+  }
+
   _strip.begin();
   _strip.setBrightness(_brightness);
-  _strip.show();
+  _output.begin();
+  _show();
 
   if (_modeTask == NULL) {
     _createModeTask();
   }
 }
 
+void NeoPixel::cancelSleepTimer() {
+  {
+    LockGuard lock (_lock);
+
+    if (!_sleepTimerActive) {
+      return;
+    }
+
+    _sleepTimerActive = false;
+  }
+
+  _notifyModeTask();
+}
+
 void NeoPixel::end() {
   _deleteModeTask();
+  _output.end();
   _preferences.end();
 }
 
+uint8_t NeoPixel::getBrightness() {
+  return _brightness;
+}
+
+uint32_t NeoPixel::getColor() {
+  LockGuard lock (_lock);
+
+  return ((uint32_t) _r << 16) | ((uint32_t) _g << 8) | _b;
+}
+
+uint32_t NeoPixel::getFirstFrameMicros() {
+  return _firstFrameMicros;
+}
+
+NeoPixelFrameStats NeoPixel::getFrameStats() {
+  return _frameStats;
+}
+
+uint32_t NeoPixel::getLastFrameMicros() {
+  return _lastFrameMicros;
+}
+
+NeoPixelMode NeoPixel::getMode() {
+  return _mode;
+}
+
+NeoPixelOutput& NeoPixel::getOutput() {
+  return _output;
+}
+
+uint32_t NeoPixel::getShowMicros() {
+  return _output.getShowMicros();
+}
+
+UBaseType_t NeoPixel::getStackHighWaterMark() {
+  TaskHandle_t task = _modeTask;
+
+  if (task == NULL) {
+    return 0;
+  }
+
+  return uxTaskGetStackHighWaterMark(task);
+}
+
+uint32_t NeoPixel::getWaitMillis() {
+  uint32_t stepMillis = _getStepMillis();
+  uint32_t sinceLastStep = _clock->getMillis() - _lastStepTime;
+  uint32_t waitMillis = (sinceLastStep > stepMillis) ? 0 : stepMillis - sinceLastStep;
+
+  waitMillis = min(waitMillis, _getPlaylistWaitMillis());
+  waitMillis = min(waitMillis, _getSleepWaitMillis());
+
+  return waitMillis;
+}
+
+bool NeoPixel::isPlaylistActive() {
+  return _playlistActive;
+}
+
+bool NeoPixel::isSleepTimerActive() {
+  return _sleepTimerActive;
+}
+
 void NeoPixel::nextBrightness() {
   _setBrightness((uint16_t) _brightness + NEOPIXEL_BRIGHTNESS_STEP, true);
 }
 
 void NeoPixel::nextMode() {
+  stopPlaylist();
+
   uint8_t mode = (uint8_t) _mode;
   mode++;
   if (mode > NEOPIXEL_MAX_MODE) {
@@ -342,14 +815,144 @@ void NeoPixel::nextMode() {
   _setMode((NeoPixelMode) mode, true);
 }
 
+void NeoPixel::onFrame(NeoPixelFrameHandler callback) {
+  LockGuard lock (_lock);
+  _frameHandler = callback;
+}
+
+void NeoPixel::previousMode() {
+  stopPlaylist();
+
+  uint8_t mode = (uint8_t) _mode;
+  if (mode == 0) {
+    mode = NEOPIXEL_MAX_MODE;
+  } else {
+    mode--;
+  }
+
+  _setMode((NeoPixelMode) mode, true);
+}
+
+void NeoPixel::resetFrameStats() {
+  _frameStats = {};
+}
+
+void NeoPixel::resumePlaylist() {
+  {
+    LockGuard lock (_lock);
+
+    if (_playlistActive || _playlistCount == 0) {
+      return;
+    }
+
+    // Back to the entry that was stopped, which keeps its start time so its duration and fades carry on as before
+    _mode = _playlist[_playlistIndex].mode;
+    _playlistActive = true;
+    _preferences.putUChar(PLAYLIST_ACTIVE_KEY, 1);
+  }
+
+  _notifyModeTask();
+}
+
 void NeoPixel::setBrightness(uint8_t brightness) {
   _setBrightness(brightness, true);
 }
 
+void NeoPixel::setClock(Clock& clock) {
+  _clock = &clock;
+}
+
 void NeoPixel::setColor(uint8_t r, uint8_t g, uint8_t b) {
   _setColor(r, g, b, true);
 }
 
+void NeoPixel::setLinearColor(uint16_t r, uint16_t g, uint16_t b) {
+  // The strip only takes 8 bits per channel. Going through the curve from 16 bits reaches every one of those 256 levels,
+  // where 8 bits in would skip levels at the top and collapse the bottom to black
+  _setColor(gamma16(r), gamma16(g), gamma16(b), true);
+}
+
 void NeoPixel::setMode(NeoPixelMode mode) {
+  stopPlaylist();
   _setMode(mode, true);
+}
+
+bool NeoPixel::setPlaylist(const NeoPixelPlaylistEntry entries[], uint8_t count) {
+  count = min(count, (uint8_t) NEOPIXEL_PLAYLIST_MAX_ENTRIES);
+
+  if (!_isValidPlaylist(entries, count)) {
+    return false;
+  }
+
+  {
+    LockGuard lock (_lock);
+
+    _playlistCount = count;
+    _playlistIndex = 0;
+
+    // Preferences ignores a zero length write, so the old playlist would come back after a reboot
+    if (_playlistCount == 0) {
+      _preferences.remove(PLAYLIST_KEY);
+    } else {
+      memcpy(_playlist, entries, _playlistCount * sizeof(NeoPixelPlaylistEntry));
+      _preferences.putBytes(PLAYLIST_KEY, _playlist, _playlistCount * sizeof(NeoPixelPlaylistEntry));
+    }
+  }
+
+  if (_playlistActive) {
+    _applyPlaylistEntry(0);
+    _notifyModeTask();
+  }
+
+  return true;
+}
+
+void NeoPixel::setSleepTimer(uint32_t fadeMillis) {
+  {
+    LockGuard lock (_lock);
+
+    _sleepTimerActive = true;
+    _sleepTimerMillis = fadeMillis;
+    _sleepTimerStartTime = _clock->getMillis();
+  }
+
+  log_d("Sleep timer: %u ms", fadeMillis);
+
+  _notifyModeTask();
+}
+
+void NeoPixel::setTaskSchedule(const TaskSchedule& schedule) {
+  _taskCore = schedule.core;
+  _taskPriority = schedule.priority;
+}
+
+void NeoPixel::startPlaylist() {
+  {
+    LockGuard lock (_lock);
+
+    if (_playlistActive || _playlistCount == 0) {
+      return;
+    }
+
+    _playlistActive = true;
+    _preferences.putUChar(PLAYLIST_ACTIVE_KEY, 1);
+  }
+
+  _applyPlaylistEntry(0);
+  _notifyModeTask();
+}
+
+void NeoPixel::stopPlaylist() {
+  {
+    LockGuard lock (_lock);
+
+    if (!_playlistActive) {
+      return;
+    }
+
+    _playlistActive = false;
+    _preferences.putUChar(PLAYLIST_ACTIVE_KEY, 0);
+  }
+
+  _notifyModeTask();
 }
\ No newline at end of file
@@ -5,12 +5,19 @@
 #include <Adafruit_NeoPixel.h>
 #include <Preferences.h>
 
+#include "Clock.h"
+#include "Delegate.h"
+#include "FixedMath.h"
 #include "LockGuard.h"
+#include "NeoPixelOutput.h"
+#include "SchedulingProfile.h"
 
 #define NEOPIXEL_MODE_TASK_CORE tskNO_AFFINITY
 #define NEOPIXEL_MODE_TASK_PRIORITY (configMAX_PRIORITIES-1)
 #define NEOPIXEL_MODE_TASK_STACK_SIZE 2048
 
+#define NEOPIXEL_MODE_UPDATE_NOTIFICATION (1 << 0)
+
 enum class NeoPixelMode: uint8_t {
     Off = 0,
     Solid = 1,
@@ -20,56 +27,187 @@ enum class NeoPixelMode: uint8_t {
     Rainbow = 5,
     RainbowWave = 6,
     TheaterChaseRainbow = 7,
+    Plasma = 8,
+    Fire = 9,
+    Ripples = 10,
+    Noise = 11,
 };
 
 #define NEOPIXEL_BRIGHTNESS_STEP 50
 #define NEOPIXEL_DEFAULT_MODE 1
+#ifndef NEOPIXEL_LED_COLS
 #define NEOPIXEL_LED_COLS 8
-#define NEOPIXEL_LED_COUNT 32
+#endif
+#ifndef NEOPIXEL_LED_ROWS
 #define NEOPIXEL_LED_ROWS 4
-#define NEOPIXEL_MAX_MODE 7
+#endif
+#define NEOPIXEL_LED_COUNT (NEOPIXEL_LED_COLS * NEOPIXEL_LED_ROWS)
+#define NEOPIXEL_MAX_MODE 11
 #define NEOPIXEL_STEP_MILLIS 50
 
+#define NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS 1800000
+#define NEOPIXEL_RTC_STATE_MAGIC 0x4E454F50
+
+#define NEOPIXEL_PLAYLIST_FADE_MILLIS 2000
+#define NEOPIXEL_PLAYLIST_FADE_STEP_MILLIS 20
+#define NEOPIXEL_PLAYLIST_MAX_ENTRIES 16
+
+enum class NeoPixelTransition: uint8_t {
+    Cut = 0,
+    Fade = 1
+};
+
+// A black color or a zero brightness keeps whatever was last set by the inputs
+struct NeoPixelPlaylistEntry {
+  NeoPixelMode mode;
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t brightness;
+  NeoPixelTransition transition;
+  uint16_t duration; // Seconds
+};
+
+// Render state kept in RTC memory across the sleep timer's deep sleep, the playlist too so waking up reads nothing
+// from NVS
+struct NeoPixelRtcState {
+  uint32_t magic;
+  uint8_t b;
+  uint8_t brightness;
+  uint16_t currentStep;
+  uint8_t g;
+  NeoPixelMode mode;
+  NeoPixelPlaylistEntry playlist[NEOPIXEL_PLAYLIST_MAX_ENTRIES];
+  bool playlistActive;
+  uint8_t playlistCount;
+  uint8_t playlistIndex;
+  uint8_t r;
+  uint16_t stepDirection;
+};
+
+struct NeoPixelFrameStats {
+  uint32_t frames;
+  uint32_t maxLateMicros;
+  uint32_t maxRenderMicros;
+  uint32_t steps;
+  uint64_t totalLateMicros;
+  uint64_t totalRenderMicros;
+};
+
+typedef Delegate<void(const uint8_t*, uint16_t)> NeoPixelFrameHandler;
+
 class NeoPixel {
   public:
     NeoPixel(uint8_t pin);
+    NeoPixel(const uint8_t pins[], uint8_t stripCount);
     ~NeoPixel();
 
     void begin();
+    void cancelSleepTimer();
     void end();
+    uint8_t getBrightness();
+    // Packed as 0x00RRGGBB, the same as Adafruit_NeoPixel::Color
+    uint32_t getColor();
+    uint32_t getFirstFrameMicros();
+    NeoPixelFrameStats getFrameStats();
+    uint32_t getLastFrameMicros();
+    NeoPixelMode getMode();
+    NeoPixelOutput& getOutput();
+    uint32_t getShowMicros();
+    UBaseType_t getStackHighWaterMark();
+    uint32_t getWaitMillis();
+    bool isPlaylistActive();
+    bool isSleepTimerActive();
     void loop();
     void nextBrightness();
     void nextMode();
+    void onFrame(NeoPixelFrameHandler callback);
+    void previousMode();
+    void resetFrameStats();
+    void resumePlaylist();
     void setBrightness(uint8_t brightness);
+    void setClock(Clock& clock);
     void setColor(uint8_t r, uint8_t g, uint8_t b);
+    void setLinearColor(uint16_t r, uint16_t g, uint16_t b);
     void setMode(NeoPixelMode mode);
+    // Refuses the whole playlist if any entry has an unknown mode or transition or no duration, an empty one removes
+    // the stored playlist so the default comes back after a reboot
+    bool setPlaylist(const NeoPixelPlaylistEntry entries[], uint8_t count);
+    void setSleepTimer(uint32_t fadeMillis = NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS);
+    void setTaskSchedule(const TaskSchedule& schedule);
+    void startPlaylist();
+    void stopPlaylist();
+    void update();
 
   private:
+    Clock* _clock = &Clock::getSystemClock();
     uint8_t _brightness = NEOPIXEL_BRIGHTNESS_STEP;
     uint8_t _r = 0;
     uint8_t _g = 0;
     uint8_t _b = 0;
+    uint16_t _currentStep = 0;
+    uint32_t _firstFrameMicros = 0;
+    NeoPixelFrameHandler _frameHandler;
+    NeoPixelFrameStats _frameStats = {};
+    volatile uint32_t _lastFrameMicros = 0;
     NeoPixelMode _lastMode;
+    uint32_t _lastStepMicros = 0;
     uint32_t _lastStepTime = 0;
-    SemaphoreHandle_t _lock;
+    SemaphoreHandle_t _lock = NULL;
+    StaticSemaphore_t _lockBuffer;
     NeoPixelMode _mode = (NeoPixelMode) NEOPIXEL_DEFAULT_MODE;
-    TaskHandle_t _modeTask;
+    TaskHandle_t _modeTask = NULL;
+    StaticTask_t _modeTaskBuffer;
+    StackType_t _modeTaskStack[NEOPIXEL_MODE_TASK_STACK_SIZE];
+    NeoPixelPlaylistEntry _playlist[NEOPIXEL_PLAYLIST_MAX_ENTRIES];
+    bool _playlistActive = false;
+    uint8_t _playlistCount = 0;
+    uint32_t _playlistEntryTime = 0;
+    uint8_t _playlistIndex = 0;
+    BaseType_t _taskCore = NEOPIXEL_MODE_TASK_CORE;
+    UBaseType_t _taskPriority = NEOPIXEL_MODE_TASK_PRIORITY;
+    NeoPixelOutput _output;
     Preferences _preferences;
+    bool _sleepTimerActive = false;
+    uint32_t _sleepTimerMillis = 0;
+    uint32_t _sleepTimerStartTime = 0;
+    uint16_t _stepDirection = 1;
     Adafruit_NeoPixel _strip;
 
     static const char* BRIGHTNESS_KEY;
+    static const NeoPixelPlaylistEntry DEFAULT_PLAYLIST[];
     static const char* MODE_KEY;
+    static const char* PLAYLIST_ACTIVE_KEY;
+    static const char* PLAYLIST_KEY;
 
+    void _applyPlaylistEntry(uint8_t index);
+    void _createLock();
     void _createModeTask();
     void _deleteModeTask();
-    TickType_t _getTicksToWait();
+    void _enterDeepSleep();
+    uint8_t _getPlaylistFade();
+    uint32_t _getPlaylistWaitMillis();
+    uint8_t _getSleepFade();
+    uint32_t _getSleepWaitMillis();
     uint32_t _getStepMillis();
+    TickType_t _getTicksToWait();
+    uint16_t _getPixelIndex(uint16_t x, uint16_t y);
     uint32_t _getWheelColor(uint8_t position);
-    void _handleMode();
+    void _handlePlaylist();
+    bool _isSleepTimerExpired();
+    static bool _isValidPlaylist(const NeoPixelPlaylistEntry entries[], uint8_t count);
     static void _modeTaskCode(void *args);
     void _notifyModeTask();
+    void _raiseOnFrame();
+    bool _restoreRtcState();
+    void _renderShader(uint32_t (NeoPixel::*shader)(uint16_t, uint16_t, uint16_t), uint16_t time);
     void _setBrightness(uint16_t brightness, bool update);
     void _setColor(uint8_t r, uint8_t g, uint8_t b, bool update);
     void _setMode(NeoPixelMode mode, bool update);
+    uint32_t _shadeFire(uint16_t x, uint16_t y, uint16_t time);
+    uint32_t _shadeNoise(uint16_t x, uint16_t y, uint16_t time);
+    uint32_t _shadePlasma(uint16_t x, uint16_t y, uint16_t time);
+    uint32_t _shadeRipples(uint16_t x, uint16_t y, uint16_t time);
+    void _show();
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "NeoPixelOutput.h"
+
+NeoPixelOutput::NeoPixelOutput() {
+  _bit0.duration0 = NEOPIXEL_OUTPUT_T0H_TICKS;
+  _bit0.level0 = 1;
+  _bit0.duration1 = NEOPIXEL_OUTPUT_T0L_TICKS;
+  _bit0.level1 = 0;
+
+  _bit1.duration0 = NEOPIXEL_OUTPUT_T1H_TICKS;
+  _bit1.level0 = 1;
+  _bit1.duration1 = NEOPIXEL_OUTPUT_T1L_TICKS;
+  _bit1.level1 = 0;
+}
+
+NeoPixelOutput::~NeoPixelOutput() {
+  end();
+}
+
+void NeoPixelOutput::_encode(const uint8_t* pixels) {
+  uint16_t byteCount = _pixelCount * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL;
+
+  // Only bytes that changed since the last frame are re-encoded into RMT items
+  for (uint16_t i = 0; i < byteCount; i++) {
+    if (_encoded && _encodedPixels[i] == pixels[i]) {
+      continue;
+    }
+
+    rmt_item32_t *item = _items + i * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE;
+
+    for (int bit = 7; bit >= 0; bit--) {
+      item->val = (pixels[i] & (1 << bit)) ? _bit1.val : _bit0.val;
+      item++;
+    }
+
+    _encodedPixels[i] = pixels[i];
+  }
+
+  _encoded = true;
+}
+
+rmt_channel_t NeoPixelOutput::_getChannel(uint8_t strip) {
+  return (rmt_channel_t) (RMT_CHANNEL_0 + strip);
+}
+
+bool NeoPixelOutput::addStrip(uint8_t pin, uint16_t count) {
+  if (_begun) {
+    log_e("Strips must be added before begin()");
+    return false;
+  }
+
+  if (_stripCount >= NEOPIXEL_OUTPUT_MAX_STRIPS) {
+    log_e("Too many strips: %d", _stripCount + 1);
+    return false;
+  }
+
+  NeoPixelSegment &segment = _segments[_stripCount];
+  segment.pin = pin;
+  segment.first = _pixelCount;
+  segment.count = count;
+
+  _pixelCount += count;
+  _stripCount++;
+
+  return true;
+}
+
+void NeoPixelOutput::begin() {
+  if (_begun) {
+    return;
+  }
+
+  uint16_t byteCount = _pixelCount * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL;
+
+  _encodedPixels = (uint8_t *) malloc(byteCount);
+  _items = (rmt_item32_t *) heap_caps_malloc(byteCount * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE * sizeof(rmt_item32_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+  if (_encodedPixels == NULL || _items == NULL) {
+    log_e("Error allocating output buffers for %d pixels", _pixelCount);
+    free(_encodedPixels);
+    heap_caps_free(_items);
+    _encodedPixels = NULL;
+    _items = NULL;
+    return;
+  }
+
+  for (uint8_t i = 0; i < _stripCount; i++) {
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t) _segments[i].pin, _getChannel(i));
+    config.clk_div = NEOPIXEL_OUTPUT_CLOCK_DIVIDER;
+
+    if (rmt_config(&config) != ESP_OK || rmt_driver_install(config.channel, 0, 0) != ESP_OK) {
+      log_e("Error configuring RMT channel %d on pin %d", i, _segments[i].pin);
+    }
+  }
+
+  _encoded = false;
+  _transmitting = false;
+  _begun = true;
+}
+
+void NeoPixelOutput::end() {
+  if (!_begun) {
+    return;
+  }
+
+  waitTransmit();
+
+  for (uint8_t i = 0; i < _stripCount; i++) {
+    rmt_driver_uninstall(_getChannel(i));
+  }
+
+  free(_encodedPixels);
+  heap_caps_free(_items);
+  _encodedPixels = NULL;
+  _items = NULL;
+
+  _begun = false;
+}
+
+uint16_t NeoPixelOutput::getPixelCount() {
+  return _pixelCount;
+}
+
+const NeoPixelSegment* NeoPixelOutput::getSegment(uint8_t strip) {
+  if (strip >= _stripCount) {
+    return NULL;
+  }
+
+  return &_segments[strip];
+}
+
+uint32_t NeoPixelOutput::getShowMicros() {
+  return _showMicros;
+}
+
+uint8_t NeoPixelOutput::getStripCount() {
+  return _stripCount;
+}
+
+uint32_t NeoPixelOutput::getTransmitMicros() {
+  uint16_t longestCount = 0;
+
+  for (uint8_t i = 0; i < _stripCount; i++) {
+    if (_segments[i].count > longestCount) {
+      longestCount = _segments[i].count;
+    }
+  }
+
+  // Strips are transmitted in parallel so the frame time is bound by the longest one
+  return ((uint32_t) longestCount * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE * NEOPIXEL_OUTPUT_BIT_NANOS) / 1000 + NEOPIXEL_OUTPUT_RESET_MICROS;
+}
+
+void NeoPixelOutput::show(const uint8_t* pixels) {
+  if (!_begun || pixels == NULL) {
+    return;
+  }
+
+  // The RMT driver keeps reading the items during the transfer so the previous frame has to finish first
+  waitTransmit();
+
+  uint32_t startTime = micros();
+
+  _encode(pixels);
+  _transmitting = true;
+
+  for (uint8_t i = 0; i < _stripCount; i++) {
+    const NeoPixelSegment &segment = _segments[i];
+    uint32_t first = (uint32_t) segment.first * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE;
+    uint32_t count = (uint32_t) segment.count * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE;
+
+    rmt_write_items(_getChannel(i), _items + first, count, false);
+  }
+
+  _showMicros = micros() - startTime;
+}
+
+void NeoPixelOutput::waitTransmit() {
+  if (!_begun || !_transmitting) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < _stripCount; i++) {
+    rmt_wait_tx_done(_getChannel(i), portMAX_DELAY);
+  }
+
+  _transmitting = false;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef EMILYS_NEOPIXEL_NEOPIXEL_OUTPUT_H
+#define EMILYS_NEOPIXEL_NEOPIXEL_OUTPUT_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include <esp_heap_caps.h>
+
+#define NEOPIXEL_OUTPUT_BYTES_PER_PIXEL 3
+#define NEOPIXEL_OUTPUT_MAX_STRIPS RMT_CHANNEL_MAX
+
+// 80MHz APB clock / 2 = 25ns per RMT tick
+#define NEOPIXEL_OUTPUT_CLOCK_DIVIDER 2
+#define NEOPIXEL_OUTPUT_T0H_TICKS 16
+#define NEOPIXEL_OUTPUT_T0L_TICKS 34
+#define NEOPIXEL_OUTPUT_T1H_TICKS 32
+#define NEOPIXEL_OUTPUT_T1L_TICKS 18
+
+#define NEOPIXEL_OUTPUT_BIT_NANOS 1250
+#define NEOPIXEL_OUTPUT_ITEMS_PER_BYTE 8
+#define NEOPIXEL_OUTPUT_RESET_MICROS 50
+
+struct NeoPixelSegment {
+  uint8_t pin;
+  uint16_t first;
+  uint16_t count;
+};
+
+class NeoPixelOutput {
+  public:
+    NeoPixelOutput();
+    ~NeoPixelOutput();
+
+    bool addStrip(uint8_t pin, uint16_t count);
+    void begin();
+    void end();
+    uint16_t getPixelCount();
+    const NeoPixelSegment* getSegment(uint8_t strip);
+    uint8_t getStripCount();
+    uint32_t getShowMicros();
+    uint32_t getTransmitMicros();
+    void show(const uint8_t* pixels);
+    void waitTransmit();
+
+  private:
+    bool _begun = false;
+    bool _encoded = false;
+    uint8_t *_encodedPixels = NULL;
+    // The RMT driver reads the items straight from memory while it transmits, so they are kept out of PSRAM
+    rmt_item32_t *_items = NULL;
+    uint16_t _pixelCount = 0;
+    NeoPixelSegment _segments[NEOPIXEL_OUTPUT_MAX_STRIPS];
+    uint32_t _showMicros = 0;
+    uint8_t _stripCount = 0;
+    bool _transmitting = false;
+
+    rmt_item32_t _bit0;
+    rmt_item32_t _bit1;
+
+    void _encode(const uint8_t* pixels);
+    static rmt_channel_t _getChannel(uint8_t strip);
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef EMILYS_NEOPIXEL_SCHEDULING_PROFILE_H
+#define EMILYS_NEOPIXEL_SCHEDULING_PROFILE_H
+
+#include <Arduino.h>
+
+// Picked at build time with -DSCHEDULING_PROFILE=<n>
+#ifndef SCHEDULING_PROFILE
+#define SCHEDULING_PROFILE 0
+#endif
+
+// The Arduino loop task runs on core 1 at priority 1, anything above that preempts it
+enum class SchedulingProfileType: uint8_t {
+    Shared = 0,
+    Split = 1,
+    RenderFirst = 2
+};
+
+struct TaskSchedule {
+  BaseType_t core;
+  UBaseType_t priority;
+};
+
+struct SchedulingProfile {
+  TaskSchedule analogInput;
+  TaskSchedule digitalInput;
+  TaskSchedule neoPixel;
+};
+
+inline SchedulingProfile getSchedulingProfile(SchedulingProfileType type) {
+  switch (type)
+  {
+    case SchedulingProfileType::Split: {
+      // Rendering owns core 1, inputs share core 0 with buttons ahead of the knobs
+      return {
+        { 0, configMAX_PRIORITIES - 3 },
+        { 0, configMAX_PRIORITIES - 2 },
+        { 1, configMAX_PRIORITIES - 1 }
+      };
+    }
+    case SchedulingProfileType::RenderFirst: {
+      // Either core, but the knob polling can never delay a frame or a button
+      return {
+        { tskNO_AFFINITY, 2 },
+        { tskNO_AFFINITY, configMAX_PRIORITIES - 2 },
+        { tskNO_AFFINITY, configMAX_PRIORITIES - 1 }
+      };
+    }
+    default: {
+      return {
+        { tskNO_AFFINITY, configMAX_PRIORITIES - 1 },
+        { tskNO_AFFINITY, configMAX_PRIORITIES - 1 },
+        { tskNO_AFFINITY, configMAX_PRIORITIES - 1 }
+      };
+    }
+  }
+}
+#endif
\ No newline at end of file
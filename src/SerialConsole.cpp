@@ -0,0 +1,263 @@
+#include "SerialConsole.h"
+
+const SerialConsoleColor SerialConsole::PALETTE[] = {
+  { "red", 255, 0, 0 },
+  { "green", 0, 255, 0 },
+  { "blue", 0, 0, 255 },
+  { "white", 255, 255, 255 },
+  { "warm", 255, 147, 41 },
+  { "cool", 201, 226, 255 },
+  { "purple", 128, 0, 255 }
+};
+
+SerialConsole::SerialConsole(Stream& stream, NeoPixel& neoPixel): _neoPixel(neoPixel), _stream(stream) {
+
+}
+
+void SerialConsole::_execute(char* line) {
+  char* args[SERIAL_CONSOLE_MAX_ARGS];
+  uint8_t count = 0;
+  char* state = NULL;
+
+  // Tokenized in place so nothing is copied or allocated
+  for (char* token = strtok_r(line, " \t", &state); token != NULL; token = strtok_r(NULL, " \t", &state)) {
+    if (count == SERIAL_CONSOLE_MAX_ARGS) {
+      _reply(false, "too many arguments");
+      return;
+    }
+
+    args[count++] = token;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  _stats.commands++;
+
+  if (strcmp(args[0], "brightness") == 0) {
+    _handleBrightness(args, count);
+  } else if (strcmp(args[0], "color") == 0) {
+    _handleColor(args, count);
+  } else if (strcmp(args[0], "mode") == 0) {
+    _handleMode(args, count);
+  } else if (strcmp(args[0], "palette") == 0) {
+    _handlePalette(args, count);
+  } else if (strcmp(args[0], "stats") == 0) {
+    _handleStats();
+  } else {
+    _reply(false, "unknown command");
+  }
+}
+
+void SerialConsole::_flush() {
+  int writable = _stream.availableForWrite();
+
+  if (_outputLength == 0 || writable <= 0) {
+    return;
+  }
+
+  size_t written = _stream.write((const uint8_t*) _output, min(_outputLength, (size_t) writable));
+
+  _outputLength -= written;
+  memmove(_output, _output + written, _outputLength);
+}
+
+void SerialConsole::_handleBrightness(char* args[], uint8_t count) {
+  uint32_t brightness;
+
+  if (count != 2 || !_parseNumber(args[1], UINT8_MAX, brightness)) {
+    _reply(false, "usage: brightness <0-255>");
+    return;
+  }
+
+  // An unchanged value never wakes the mode task, so there is no frame to time it against
+  if (brightness != _neoPixel.getBrightness()) {
+    _startFrameTimer();
+  }
+
+  _neoPixel.setBrightness(brightness);
+  _reply(true);
+}
+
+void SerialConsole::_handleColor(char* args[], uint8_t count) {
+  uint32_t r, g, b;
+
+  if (count != 4 || !_parseNumber(args[1], UINT8_MAX, r) || !_parseNumber(args[2], UINT8_MAX, g) || !_parseNumber(args[3], UINT8_MAX, b)) {
+    _reply(false, "usage: color <r> <g> <b>");
+    return;
+  }
+
+  _startColorFrameTimer(r, g, b);
+  _neoPixel.setColor(r, g, b);
+  _reply(true);
+}
+
+void SerialConsole::_handleMode(char* args[], uint8_t count) {
+  uint32_t mode;
+
+  if (count != 2 || !_parseNumber(args[1], NEOPIXEL_MAX_MODE, mode)) {
+    _reply(false, "usage: mode <number>");
+    return;
+  }
+
+  // Stopping the playlist renders even when it was already showing this mode
+  if ((NeoPixelMode) mode != _neoPixel.getMode() || _neoPixel.isPlaylistActive()) {
+    _startFrameTimer();
+  }
+
+  _neoPixel.setMode((NeoPixelMode) mode);
+  _reply(true);
+}
+
+void SerialConsole::_handlePalette(char* args[], uint8_t count) {
+  if (count != 2) {
+    _reply(false, "usage: palette <name>");
+    return;
+  }
+
+  for (size_t i = 0; i < sizeof(PALETTE) / sizeof(PALETTE[0]); i++) {
+    if (strcmp(args[1], PALETTE[i].name) == 0) {
+      _startColorFrameTimer(PALETTE[i].r, PALETTE[i].g, PALETTE[i].b);
+      _neoPixel.setColor(PALETTE[i].r, PALETTE[i].g, PALETTE[i].b);
+      _reply(true);
+      return;
+    }
+  }
+
+  _reply(false, "unknown palette color");
+}
+
+void SerialConsole::_handleStats() {
+  NeoPixelFrameStats frameStats = _neoPixel.getFrameStats();
+
+  _send("frames %u steps %u render_avg_us %u render_max_us %u late_max_us %u\n",
+    frameStats.frames,
+    frameStats.steps,
+    frameStats.frames > 0 ? (uint32_t) (frameStats.totalRenderMicros / frameStats.frames) : 0,
+    frameStats.maxRenderMicros,
+    frameStats.maxLateMicros);
+
+  _send("commands %u errors %u overflows %u latency_avg_us %u latency_max_us %u\n",
+    _stats.commands,
+    _stats.errors,
+    _stats.overflows,
+    _stats.latencySamples > 0 ? (uint32_t) (_stats.totalLatencyMicros / _stats.latencySamples) : 0,
+    _stats.maxLatencyMicros);
+
+  _reply(true);
+}
+
+bool SerialConsole::_parseNumber(const char* text, uint32_t maxValue, uint32_t& value) {
+  char* end;
+
+  value = strtoul(text, &end, 10);
+
+  return end != text && *end == '\0' && value <= maxValue;
+}
+
+void SerialConsole::_reply(bool ok, const char* message) {
+  if (!ok) {
+    _stats.errors++;
+  }
+
+  if (message == NULL) {
+    _send("%s\n", ok ? "ok" : "error");
+  } else {
+    _send("%s: %s\n", ok ? "ok" : "error", message);
+  }
+}
+
+void SerialConsole::_send(const char* format, ...) {
+  size_t space = SERIAL_CONSOLE_OUTPUT_SIZE - _outputLength;
+  va_list args;
+
+  // Straight into the output buffer, Print::printf would malloc for anything over 64 bytes
+  va_start(args, format);
+  int length = vsnprintf(_output + _outputLength, space, format, args);
+  va_end(args);
+
+  if (length > 0) {
+    _outputLength += min((size_t) length, space - 1);
+  }
+}
+
+void SerialConsole::_startColorFrameTimer(uint8_t r, uint8_t g, uint8_t b) {
+  if ((((uint32_t) r << 16) | ((uint32_t) g << 8) | b) != _neoPixel.getColor()) {
+    _startFrameTimer();
+  }
+}
+
+void SerialConsole::_startFrameTimer() {
+  // Only the first command of a burst is timed, the rest land in the same frame
+  if (_pendingFrame) {
+    return;
+  }
+
+  _pendingFrame = true;
+  _pendingFrameMicros = micros();
+}
+
+void SerialConsole::_updateLatency() {
+  if (!_pendingFrame) {
+    return;
+  }
+
+  uint32_t lastFrameMicros = _neoPixel.getLastFrameMicros();
+
+  // Still waiting on the first frame rendered after the command
+  if ((int32_t) (lastFrameMicros - _pendingFrameMicros) < 0) {
+    return;
+  }
+
+  uint32_t latency = lastFrameMicros - _pendingFrameMicros;
+
+  _stats.latencySamples++;
+  _stats.maxLatencyMicros = max(_stats.maxLatencyMicros, latency);
+  _stats.totalLatencyMicros += latency;
+
+  _pendingFrame = false;
+}
+
+SerialConsoleStats SerialConsole::getStats() {
+  return _stats;
+}
+
+void SerialConsole::poll() {
+  _updateLatency();
+  _flush();
+
+  // Whatever is left in the stream waits for the replies to drain, the longest one still has to fit
+  while (_stream.available() > 0 && _outputLength <= SERIAL_CONSOLE_OUTPUT_SIZE - SERIAL_CONSOLE_MAX_REPLY_SIZE) {
+    char c = (char) _stream.read();
+
+    if (c != '\n' && c != '\r') {
+      if (_lineLength < SERIAL_CONSOLE_LINE_SIZE - 1) {
+        _line[_lineLength++] = c;
+      } else {
+        _lineOverflow = true;
+      }
+
+      continue;
+    }
+
+    _line[_lineLength] = '\0';
+
+    if (_lineOverflow) {
+      _stats.overflows++;
+      _reply(false, "line too long");
+    } else if (_lineLength > 0) {
+      _execute(_line);
+    }
+
+    _lineLength = 0;
+    _lineOverflow = false;
+  }
+
+  _flush();
+}
+
+void SerialConsole::resetStats() {
+  _stats = {};
+  _pendingFrame = false;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef EMILYS_NEOPIXEL_SERIAL_CONSOLE_H
+#define EMILYS_NEOPIXEL_SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+#include "NeoPixel.h"
+
+#define SERIAL_CONSOLE_LINE_SIZE 64
+#define SERIAL_CONSOLE_MAX_ARGS 4
+#define SERIAL_CONSOLE_MAX_REPLY_SIZE 256
+#define SERIAL_CONSOLE_OUTPUT_SIZE 512
+
+struct SerialConsoleColor {
+  const char* name;
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+struct SerialConsoleStats {
+  uint32_t commands;
+  uint32_t errors;
+  uint32_t latencySamples;
+  uint32_t maxLatencyMicros;
+  uint32_t overflows;
+  uint64_t totalLatencyMicros;
+};
+
+// Line based commands read from a Stream a byte at a time, poll() never waits for the rest of a line. Replies are
+// formatted into a fixed buffer and only written as fast as the stream can take them, so poll() never waits on a full
+// TX FIFO either; while the buffer could not hold another reply the next lines are left unread in the stream
+class SerialConsole {
+  public:
+    SerialConsole(Stream& stream, NeoPixel& neoPixel);
+
+    SerialConsoleStats getStats();
+    void poll();
+    void resetStats();
+
+  private:
+    static const SerialConsoleColor PALETTE[];
+
+    char _line[SERIAL_CONSOLE_LINE_SIZE];
+    uint8_t _lineLength = 0;
+    bool _lineOverflow = false;
+    NeoPixel& _neoPixel;
+    char _output[SERIAL_CONSOLE_OUTPUT_SIZE];
+    size_t _outputLength = 0;
+    uint32_t _pendingFrameMicros = 0;
+    bool _pendingFrame = false;
+    SerialConsoleStats _stats = {};
+    Stream& _stream;
+
+    void _execute(char* line);
+    void _flush();
+    void _handleBrightness(char* args[], uint8_t count);
+    void _handleColor(char* args[], uint8_t count);
+    void _handleMode(char* args[], uint8_t count);
+    void _handlePalette(char* args[], uint8_t count);
+    void _handleStats();
+    static bool _parseNumber(const char* text, uint32_t maxValue, uint32_t& value);
+    void _reply(bool ok, const char* message = NULL);
+    void _send(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void _startColorFrameTimer(uint8_t r, uint8_t g, uint8_t b);
+    void _startFrameTimer();
+    void _updateLatency();
+};
+#endif
\ No newline at end of file
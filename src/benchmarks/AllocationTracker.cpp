@@ -0,0 +1,98 @@
+#include "AllocationTracker.h"
+
+#ifdef ALLOCATION_TRACKER
+#include <atomic>
+#include <esp_heap_caps.h>
+
+struct AllocationCount {
+  std::atomic<TaskHandle_t> task;
+  std::atomic<uint32_t> count;
+};
+
+// Filled in by the malloc wrappers once setup() is done, every allocation after that is one the loop should not make
+static AllocationCount allocationCounts[ALLOCATION_TRACKER_MAX_TASKS];
+static std::atomic<uint32_t> allocationBytes { 0 };
+static std::atomic<uint32_t> allocations { 0 };
+static std::atomic<TaskHandle_t> allocationReportTask { NULL };
+static std::atomic<bool> allocationTracking { false };
+static size_t allocationBaselineFree = 0;
+
+// The wrappers get every call, including the ones inside the Arduino core and the C++ runtime. FreeRTOS allocates
+// through heap_caps_malloc instead, the free heap in the report covers that
+extern "C" {
+  void* __real_calloc(size_t count, size_t size);
+  void* __real_malloc(size_t size);
+  void* __real_realloc(void* pointer, size_t size);
+}
+
+static void trackAllocation(size_t size) {
+  if (!allocationTracking) {
+    return;
+  }
+
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+  if (task == allocationReportTask) {
+    return;
+  }
+
+  allocations++;
+  allocationBytes += size;
+
+  // A slot is claimed by the first allocation from each task, past the last slot only the totals count
+  for (uint8_t i = 0; i < ALLOCATION_TRACKER_MAX_TASKS; i++) {
+    TaskHandle_t slotTask = NULL;
+
+    if (allocationCounts[i].task.compare_exchange_strong(slotTask, task) || slotTask == task) {
+      allocationCounts[i].count++;
+      return;
+    }
+  }
+}
+
+void beginAllocationTracker() {
+  // Everything is in place, from here on the heap should stay exactly where it is
+  allocationBaselineFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  allocationTracking = true;
+}
+
+void reportAllocations() {
+  char tasks[128] = "";
+  size_t length = 0;
+
+  // Logging a line this long allocates, the wrappers leave this task alone until it is out
+  allocationReportTask = xTaskGetCurrentTaskHandle();
+
+  for (uint8_t i = 0; i < ALLOCATION_TRACKER_MAX_TASKS; i++) {
+    TaskHandle_t task = allocationCounts[i].task;
+
+    if (task != NULL && length < sizeof(tasks)) {
+      length += snprintf(tasks + length, sizeof(tasks) - length, " %s %u", pcTaskGetTaskName(task), (uint32_t) allocationCounts[i].count);
+    }
+  }
+
+  log_w("Allocations since setup: %u, %u bytes, free heap %d bytes from setup, minimum %u bytes, by task:%s",
+    (uint32_t) allocations,
+    (uint32_t) allocationBytes,
+    (int) (heap_caps_get_free_size(MALLOC_CAP_8BIT) - allocationBaselineFree),
+    heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+    length > 0 ? tasks : " none");
+
+  allocationReportTask = NULL;
+}
+
+extern "C" void* __wrap_calloc(size_t count, size_t size) {
+  trackAllocation(count * size);
+  return __real_calloc(count, size);
+}
+
+extern "C" void* __wrap_malloc(size_t size) {
+  trackAllocation(size);
+  return __real_malloc(size);
+}
+
+extern "C" void* __wrap_realloc(void* pointer, size_t size) {
+  trackAllocation(size);
+  return __real_realloc(pointer, size);
+}
+#endif
\ No newline at end of file
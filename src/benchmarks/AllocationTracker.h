@@ -0,0 +1,13 @@
+#ifndef EMILYS_NEOPIXEL_ALLOCATION_TRACKER_H
+#define EMILYS_NEOPIXEL_ALLOCATION_TRACKER_H
+
+#include <Arduino.h>
+
+#define ALLOCATION_TRACKER_INTERVAL 10000
+#define ALLOCATION_TRACKER_MAX_TASKS 8
+
+// Counts every allocation by task once tracking starts at the end of setup(), from then on the loop should make none.
+// The allocation_tracker environment links with -Wl,--wrap so the malloc, calloc and realloc wrappers get every call
+void beginAllocationTracker();
+void reportAllocations();
+#endif
\ No newline at end of file
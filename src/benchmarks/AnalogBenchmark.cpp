@@ -0,0 +1,25 @@
+#include "AnalogBenchmark.h"
+
+#ifdef ANALOG_BENCHMARK
+void reportAnalogBenchmark(AnalogFrontEnd& analogFrontEnd, const uint8_t pins[], uint8_t pinCount) {
+  uint32_t startTime = micros();
+
+  for (int i = 0; i < ANALOG_BENCHMARK_READS; i++) {
+    for (int j = 0; j < pinCount; j++) {
+      analogRead(pins[j]);
+    }
+  }
+
+  uint32_t analogReadNanos = (micros() - startTime) * 1000 / (ANALOG_BENCHMARK_READS * pinCount);
+
+  AnalogFrontEndStats stats = analogFrontEnd.getStats();
+
+  log_w("ADC: front end %u ns per sample, burst max %u us over %u bursts, analogRead %u ns per sample",
+    stats.samples > 0 ? (uint32_t) (stats.totalBurstMicros * 1000 / stats.samples) : 0,
+    stats.maxBurstMicros,
+    stats.bursts,
+    analogReadNanos);
+
+  analogFrontEnd.resetStats();
+}
+#endif
\ No newline at end of file
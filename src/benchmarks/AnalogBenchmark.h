@@ -0,0 +1,13 @@
+#ifndef EMILYS_NEOPIXEL_ANALOG_BENCHMARK_H
+#define EMILYS_NEOPIXEL_ANALOG_BENCHMARK_H
+
+#include <Arduino.h>
+
+#include "AnalogFrontEnd.h"
+
+#define ANALOG_BENCHMARK_INTERVAL 5000
+#define ANALOG_BENCHMARK_READS 100
+
+// Logs the front end's cost per sample next to one analogRead per knob per sample, the path it replaced
+void reportAnalogBenchmark(AnalogFrontEnd& analogFrontEnd, const uint8_t pins[], uint8_t pinCount);
+#endif
\ No newline at end of file
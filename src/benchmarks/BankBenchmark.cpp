@@ -0,0 +1,49 @@
+#include "BankBenchmark.h"
+
+#ifdef BANK_BENCHMARK
+#include <new>
+
+#include "DigitalInputBank.h"
+
+// Rebuilt in place for every bank size so each one is timed from empty, it is too big for the loop task's stack
+alignas(DigitalInputBank) static uint8_t benchmarkBankBuffer[sizeof(DigitalInputBank)];
+
+void reportBankBenchmark() {
+  static const uint8_t inputCounts[] = { 1, 8, 32 };
+  uint32_t seed = 1;
+
+  for (uint8_t i = 0; i < sizeof(inputCounts); i++) {
+    // Never started, the benchmark feeds it synthetic levels so the pins are never touched
+    DigitalInputBank* benchmarkBank = new (benchmarkBankBuffer) DigitalInputBank();
+
+    for (uint8_t pin = 0; pin < inputCounts[i]; pin++) {
+      benchmarkBank->addInput(pin);
+      benchmarkBank->setLongTrigger(pin);
+      benchmarkBank->setMultiTrigger(pin);
+    }
+
+    for (int update = 0; update < BANK_BENCHMARK_UPDATES; update++) {
+      // Every pin toggles every 8 ticks and bounces on the first 2 ticks after each edge
+      uint64_t levels = ((update >> 3) & 1) ? UINT32_MAX : 0;
+
+      if ((update & 7) < 2) {
+        seed = seed * 1664525 + 1013904223;
+        levels ^= seed;
+      }
+
+      benchmarkBank->update(levels);
+    }
+
+    DigitalInputBankStats stats = benchmarkBank->getStats();
+    benchmarkBank->~DigitalInputBank();
+    uint32_t averageTickNanos = (uint32_t) (stats.totalTickMicros * 1000 / stats.ticks);
+
+    log_w("Bank of %d inputs: tick avg %u ns max %u us, %u ns per input, %u events",
+      inputCounts[i],
+      averageTickNanos,
+      stats.maxTickMicros,
+      averageTickNanos / inputCounts[i],
+      stats.events);
+  }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef EMILYS_NEOPIXEL_BANK_BENCHMARK_H
+#define EMILYS_NEOPIXEL_BANK_BENCHMARK_H
+
+#include <Arduino.h>
+
+#define BANK_BENCHMARK_INTERVAL 5000
+#define BANK_BENCHMARK_UPDATES 1000
+
+// Times DigitalInputBank updates for 1, 8 and 32 inputs fed synthetic bouncing levels, no pins are touched
+void reportBankBenchmark();
+#endif
\ No newline at end of file
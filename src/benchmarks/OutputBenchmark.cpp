@@ -0,0 +1,81 @@
+#include "OutputBenchmark.h"
+
+#ifdef OUTPUT_BENCHMARK
+#include <Adafruit_NeoPixel.h>
+
+#include "NeoPixel.h"
+#include "NeoPixelOutput.h"
+
+struct OutputBenchmarkTimes {
+  uint32_t maxMicros;
+  uint64_t totalMicros;
+};
+
+static OutputBenchmarkTimes adafruitShowTimes = {};
+static OutputBenchmarkTimes outputFrameTimes = {};
+static OutputBenchmarkTimes outputShowTimes = {};
+static uint32_t outputTransmitMicros = 0;
+
+static void addTime(OutputBenchmarkTimes& times, uint32_t micros) {
+  times.maxMicros = max(times.maxMicros, micros);
+  times.totalMicros += micros;
+}
+
+static void fillFrame(Adafruit_NeoPixel& strip, uint8_t frame) {
+  // Every byte differs from the frame before, so NeoPixelOutput re-encodes all of them like Adafruit_NeoPixel always does
+  strip.fill(Adafruit_NeoPixel::Color(frame, ~frame, frame ^ 0x55));
+}
+
+void runOutputBenchmark(uint8_t pin) {
+  Adafruit_NeoPixel strip = Adafruit_NeoPixel(NEOPIXEL_LED_COUNT, pin, NEO_GRB + NEO_KHZ800);
+
+  strip.begin();
+
+  // Frames are a millisecond apart so Adafruit_NeoPixel never waits out its latch and NeoPixelOutput never waits on
+  // the previous transfer, each show() is timed on its own
+  for (int frame = 0; frame < OUTPUT_BENCHMARK_FRAMES; frame++) {
+    fillFrame(strip, frame);
+
+    uint32_t startTime = micros();
+    strip.show();
+    addTime(adafruitShowTimes, micros() - startTime);
+
+    delay(1);
+  }
+
+  NeoPixelOutput output;
+
+  output.addStrip(pin, NEOPIXEL_LED_COUNT);
+  output.begin();
+
+  for (int frame = 0; frame < OUTPUT_BENCHMARK_FRAMES; frame++) {
+    fillFrame(strip, frame);
+
+    uint32_t startTime = micros();
+    output.show(strip.getPixels());
+    uint32_t showTime = micros();
+    output.waitTransmit();
+
+    addTime(outputShowTimes, showTime - startTime);
+    addTime(outputFrameTimes, micros() - startTime);
+
+    delay(1);
+  }
+
+  outputTransmitMicros = output.getTransmitMicros();
+  output.end();
+}
+
+void reportOutputBenchmark() {
+  // Adafruit_NeoPixel::show() blocks for the whole transfer, NeoPixelOutput::show() returns once it has started it
+  log_w("Output of %d pixels: Adafruit_NeoPixel show avg %u us max %u us, NeoPixelOutput show avg %u us max %u us, show and transmit avg %u us max %u us, transmit %u us",
+    NEOPIXEL_LED_COUNT,
+    (uint32_t) (adafruitShowTimes.totalMicros / OUTPUT_BENCHMARK_FRAMES),
+    adafruitShowTimes.maxMicros,
+    (uint32_t) (outputShowTimes.totalMicros / OUTPUT_BENCHMARK_FRAMES),
+    outputShowTimes.maxMicros,
+    (uint32_t) (outputFrameTimes.totalMicros / OUTPUT_BENCHMARK_FRAMES),
+    outputFrameTimes.maxMicros,
+    outputTransmitMicros);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef EMILYS_NEOPIXEL_OUTPUT_BENCHMARK_H
+#define EMILYS_NEOPIXEL_OUTPUT_BENCHMARK_H
+
+#include <Arduino.h>
+
+#define OUTPUT_BENCHMARK_FRAMES 100
+#define OUTPUT_BENCHMARK_INTERVAL 5000
+
+// Times Adafruit_NeoPixel::show() against NeoPixelOutput::show() on the same pin with the same frames. Both take an RMT
+// channel, so it runs once from setup() before NeoPixel::begin() and the report repeats the result
+void runOutputBenchmark(uint8_t pin);
+void reportOutputBenchmark();
+#endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "RenderBenchmark.h"
+
+#ifdef RENDER_BENCHMARK
+static const NeoPixelMode modes[] = { NeoPixelMode::Plasma, NeoPixelMode::Fire, NeoPixelMode::Ripples, NeoPixelMode::Noise };
+static uint8_t modeIndex = 0;
+
+void beginRenderBenchmark(NeoPixel& neoPixel) {
+  neoPixel.setMode(modes[modeIndex]);
+}
+
+void reportRenderBenchmark(NeoPixel& neoPixel) {
+  NeoPixelFrameStats frameStats = neoPixel.getFrameStats();
+  uint32_t averageRenderMicros = frameStats.frames > 0 ? (uint32_t) (frameStats.totalRenderMicros / frameStats.frames) : 0;
+
+  // The fps figure is the render cost alone, transmit time is reported separately
+  log_w("Mode %d at %dx%d: render avg %u us max %u us (%u fps), show %u us, transmit %u us",
+    modes[modeIndex],
+    NEOPIXEL_LED_COLS,
+    NEOPIXEL_LED_ROWS,
+    averageRenderMicros,
+    frameStats.maxRenderMicros,
+    averageRenderMicros > 0 ? 1000000 / averageRenderMicros : 0,
+    neoPixel.getShowMicros(),
+    neoPixel.getOutput().getTransmitMicros());
+
+  modeIndex = (modeIndex + 1) % (sizeof(modes) / sizeof(modes[0]));
+
+  neoPixel.setMode(modes[modeIndex]);
+  neoPixel.resetFrameStats();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef EMILYS_NEOPIXEL_RENDER_BENCHMARK_H
+#define EMILYS_NEOPIXEL_RENDER_BENCHMARK_H
+
+#include <Arduino.h>
+
+#include "NeoPixel.h"
+
+#define RENDER_BENCHMARK_INTERVAL 5000
+
+// Cycles through the 2D effects, logging how long the last one took to render before moving on to the next
+void beginRenderBenchmark(NeoPixel& neoPixel);
+void reportRenderBenchmark(NeoPixel& neoPixel);
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "SchedulingBenchmark.h"
+
+#ifdef SCHEDULING_BENCHMARK
+#include <atomic>
+#include <driver/gpio.h>
+
+// Driven by the edge task through the pin's own output, so every run sees the same presses without anyone at the buttons
+static DigitalInput edgeInput = DigitalInput(SCHEDULING_BENCHMARK_EDGE_PIN);
+static StaticTask_t edgeTaskBuffer;
+static StackType_t edgeTaskStack[SCHEDULING_BENCHMARK_EDGE_STACK_SIZE];
+static std::atomic<uint32_t> edgeTransitions { 0 };
+static StaticTask_t loadTaskBuffers[portNUM_PROCESSORS];
+static StackType_t loadTaskStacks[portNUM_PROCESSORS][SCHEDULING_BENCHMARK_LOAD_STACK_SIZE];
+
+static void edgeTaskCode(void *args) {
+  // Presses and releases the loopback pin on a fixed beat, bouncing a couple of times before each level settles
+  bool pressed = false;
+
+  for(;;) {
+    vTaskDelay(pdMS_TO_TICKS(SCHEDULING_BENCHMARK_EDGE_INTERVAL));
+
+    pressed = !pressed;
+
+    for (int i = 2 * SCHEDULING_BENCHMARK_EDGE_BOUNCES; i >= 0; i--) {
+      digitalWrite(SCHEDULING_BENCHMARK_EDGE_PIN, (pressed == (i % 2 == 0)) ? LOW : HIGH);
+      delayMicroseconds(SCHEDULING_BENCHMARK_EDGE_BOUNCE_MICROS);
+    }
+
+    edgeTransitions++;
+  }
+
+  vTaskDelete(NULL);
+}
+
+static void loadTaskCode(void *args) {
+  // Busy for part of every period to stand in for knob and other background activity
+  for(;;) {
+    uint32_t startTime = millis();
+
+    while (millis() - startTime < SCHEDULING_BENCHMARK_LOAD_PERIOD * SCHEDULING_BENCHMARK_LOAD_PERCENT / 100) {
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(SCHEDULING_BENCHMARK_LOAD_PERIOD * (100 - SCHEDULING_BENCHMARK_LOAD_PERCENT) / 100));
+  }
+
+  vTaskDelete(NULL);
+}
+
+void beginSchedulingBenchmark(const SchedulingProfile& schedulingProfile, NeoPixel& neoPixel) {
+  // Rainbow steps every 10ms so it is the most sensitive to late frames
+  neoPixel.setMode(NeoPixelMode::Rainbow);
+
+  // Input and output both enabled, the interrupt fires on the levels the edge task writes
+  digitalWrite(SCHEDULING_BENCHMARK_EDGE_PIN, HIGH);
+  gpio_set_direction((gpio_num_t) SCHEDULING_BENCHMARK_EDGE_PIN, GPIO_MODE_INPUT_OUTPUT);
+
+  edgeInput.setTaskSchedule(schedulingProfile.digitalInput);
+  edgeInput.setDebounce();
+  edgeInput.begin();
+
+  xTaskCreateStaticPinnedToCore(edgeTaskCode, "scheduling_edge_task", SCHEDULING_BENCHMARK_EDGE_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, edgeTaskStack, &edgeTaskBuffer, tskNO_AFFINITY);
+
+  for (int i = 0; i < portNUM_PROCESSORS; i++) {
+    xTaskCreateStaticPinnedToCore(loadTaskCode, "scheduling_load_task", SCHEDULING_BENCHMARK_LOAD_STACK_SIZE, NULL, SCHEDULING_BENCHMARK_LOAD_PRIORITY, loadTaskStacks[i], &loadTaskBuffers[i], i);
+  }
+}
+
+DigitalInput& getSchedulingEdgeInput() {
+  return edgeInput;
+}
+
+void reportSchedulingBenchmark(NeoPixel& neoPixel, DigitalInput& brightnessButton, DigitalInput& modeButton) {
+  NeoPixelFrameStats frameStats = neoPixel.getFrameStats();
+  DigitalInputStats brightnessStats = brightnessButton.getStats();
+  DigitalInputStats edgeStats = edgeInput.getStats();
+  DigitalInputStats modeStats = modeButton.getStats();
+  uint32_t latencySamples = brightnessStats.latencySamples + modeStats.latencySamples;
+
+  // Long triggers come from a timeout rather than a settled edge, so only transitions carry a latency
+  log_w("Profile %d: %u frames, %u steps, late avg %u us max %u us, input latency avg %u ms max %u ms over %u transitions",
+    SCHEDULING_PROFILE,
+    frameStats.frames,
+    frameStats.steps,
+    frameStats.steps > 0 ? (uint32_t) (frameStats.totalLateMicros / frameStats.steps) : 0,
+    frameStats.maxLateMicros,
+    latencySamples > 0 ? (brightnessStats.totalLatency + modeStats.totalLatency) / latencySamples : 0,
+    max(brightnessStats.maxLatency, modeStats.maxLatency),
+    latencySamples);
+
+  // A transition written but never seen as an event was lost to the load, not just late
+  log_w("Profile %d: synthetic latency avg %u ms max %u ms, %u of %u transitions, %u edges, %u dropped",
+    SCHEDULING_PROFILE,
+    edgeStats.latencySamples > 0 ? edgeStats.totalLatency / edgeStats.latencySamples : 0,
+    edgeStats.maxLatency,
+    edgeStats.events,
+    edgeTransitions.exchange(0),
+    edgeStats.edges,
+    edgeStats.droppedEdges);
+
+  neoPixel.resetFrameStats();
+  brightnessButton.resetStats();
+  edgeInput.resetStats();
+  modeButton.resetStats();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef EMILYS_NEOPIXEL_SCHEDULING_BENCHMARK_H
+#define EMILYS_NEOPIXEL_SCHEDULING_BENCHMARK_H
+
+#include <Arduino.h>
+
+#include "DigitalInput.h"
+#include "NeoPixel.h"
+#include "SchedulingProfile.h"
+
+#define SCHEDULING_BENCHMARK_EDGE_BOUNCES 2
+#define SCHEDULING_BENCHMARK_EDGE_BOUNCE_MICROS 300
+#define SCHEDULING_BENCHMARK_EDGE_INTERVAL 60
+#define SCHEDULING_BENCHMARK_EDGE_PIN 27
+#define SCHEDULING_BENCHMARK_EDGE_STACK_SIZE 1024
+#define SCHEDULING_BENCHMARK_INTERVAL 10000
+#define SCHEDULING_BENCHMARK_LOAD_PERIOD 10
+#define SCHEDULING_BENCHMARK_LOAD_PERCENT 50
+// The same for every profile so they are compared under the same load, at the WiFi task's priority
+#define SCHEDULING_BENCHMARK_LOAD_PRIORITY (configMAX_PRIORITIES - 2)
+#define SCHEDULING_BENCHMARK_LOAD_STACK_SIZE 1024
+
+// Presses and releases GPIO 27 as a loopback through its own DigitalInput and keeps both cores half busy, then logs
+// frame lateness and input latency for the profile the lamp's tasks were started with
+void beginSchedulingBenchmark(const SchedulingProfile& schedulingProfile, NeoPixel& neoPixel);
+DigitalInput& getSchedulingEdgeInput();
+void reportSchedulingBenchmark(NeoPixel& neoPixel, DigitalInput& brightnessButton, DigitalInput& modeButton);
+#endif
\ No newline at end of file
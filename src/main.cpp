@@ -1,10 +1,24 @@
 #include <Arduino.h>
 
+#include "AnalogFrontEnd.h"
+#include "ButtonGestures.h"
 #include "ColorInput.h"
 #include "DigitalInput.h"
+#include "FrameSink.h"
+#include "GestureRecognizer.h"
 #include "NeoPixel.h"
+#include "SchedulingProfile.h"
+#include "SerialConsole.h"
+#include "benchmarks/AllocationTracker.h"
+#include "benchmarks/AnalogBenchmark.h"
+#include "benchmarks/BankBenchmark.h"
+#include "benchmarks/OutputBenchmark.h"
+#include "benchmarks/RenderBenchmark.h"
+#include "benchmarks/SchedulingBenchmark.h"
 
+#define BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW 1000
 #define BRIGHTNESS_BUTTON_PIN 25
+#define MODE_BUTTON_LONG_TRIGGER_WINDOW 1000
 #define MODE_BUTTON_PIN 26
 #define NEOPIXEL_CONTROL_PIN 32
 
@@ -12,56 +26,269 @@
 #define GREEN_PIN 39
 #define BLUE_PIN 36
 
+#define GESTURE_REPORT_INTERVAL 60000
+#define LOOP_INTERVAL 10
+#define STACK_REPORT_INTERVAL 60000
+
+#ifndef FRAME_SINK_MODE
+#define FRAME_SINK_MODE 5
+#endif
+#define FRAME_SINK_REPORT_INTERVAL 5000
+
+AnalogFrontEnd analogFrontEnd = AnalogFrontEnd();
+
 DigitalInput brightnessButton = DigitalInput(BRIGHTNESS_BUTTON_PIN);
+GestureRecognizer brightnessGestures = GestureRecognizer(ButtonGestures::BRIGHTNESS_GESTURES, BRIGHTNESS_GESTURE_COUNT);
 ColorInput colorInput = ColorInput(RED_PIN, GREEN_PIN, BLUE_PIN);
 DigitalInput modeButton = DigitalInput(MODE_BUTTON_PIN);
+GestureRecognizer modeGestures = GestureRecognizer(ButtonGestures::MODE_GESTURES, MODE_GESTURE_COUNT);
 NeoPixel neoPixel = NeoPixel(NEOPIXEL_CONTROL_PIN);
+ButtonGestures buttonGestures = ButtonGestures(neoPixel);
+
+#ifdef FRAME_SINK
+// Only advanced by captured frames, one step each, so a capture does not depend on when the mode task wakes up or
+// how fast the serial port drains
+VirtualClock frameClock = VirtualClock();
+FrameSink frameSink = FrameSink(Serial, NEOPIXEL_LED_COLS, NEOPIXEL_LED_ROWS, (FrameSinkFormat) FRAME_SINK);
+#else
+// The frame sink owns the serial port when it is enabled, replies would corrupt its stream
+SerialConsole serialConsole = SerialConsole(Serial, neoPixel);
+#endif
 
-void onBrightnessButtonEvent(DigitalInputEvent event);
 void onColorEvent(uint16_t red, uint16_t green, uint16_t blue);
-void onModeButtonEvent(DigitalInputEvent event);
+void onNeoPixelFrame(const uint8_t* pixels, uint16_t count);
+void reportFrameSink();
+void reportGestureStats();
+void reportStackHighWaterMarks();
 
 void setup() {
   pinMode(BRIGHTNESS_BUTTON_PIN, INPUT_PULLUP);
   pinMode(MODE_BUTTON_PIN, INPUT_PULLUP);
 
   esp_sleep_enable_ext0_wakeup((gpio_num_t) MODE_BUTTON_PIN, LOW);
-  
-  analogReadResolution(8);
 
+  SchedulingProfile schedulingProfile = getSchedulingProfile((SchedulingProfileType) SCHEDULING_PROFILE);
+
+  brightnessButton.setTaskSchedule(schedulingProfile.digitalInput);
+  colorInput.setTaskSchedule(schedulingProfile.analogInput);
+  modeButton.setTaskSchedule(schedulingProfile.digitalInput);
+  neoPixel.setTaskSchedule(schedulingProfile.neoPixel);
+
+  brightnessGestures.begin();
+  brightnessGestures.onEvent(GestureEventHandler::bind<ButtonGestures, &ButtonGestures::handleBrightnessGesture>(&buttonGestures));
+  brightnessGestures.setInput(brightnessButton);
+
+  brightnessButton.setDebounce();
+  brightnessButton.setLongTrigger(BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW);
   brightnessButton.begin();
-  brightnessButton.onEvent(onBrightnessButtonEvent);
+  brightnessButton.onEvent(DigitalInputEventHandler::bind<GestureRecognizer, &GestureRecognizer::handleEvent>(&brightnessGestures));
 
+  colorInput.setFrontEnd(analogFrontEnd);
   colorInput.begin();
+#ifndef FRAME_SINK
+  // The knobs would make every capture different
   colorInput.onEvent(onColorEvent);
+#endif
+
+  modeGestures.begin();
+  modeGestures.onEvent(GestureEventHandler::bind<ButtonGestures, &ButtonGestures::handleModeGesture>(&buttonGestures));
+  modeGestures.setInput(modeButton);
 
+  modeButton.setDebounce();
+  modeButton.setLongTrigger(MODE_BUTTON_LONG_TRIGGER_WINDOW);
   modeButton.begin();
-  modeButton.onEvent(onModeButtonEvent);
+  modeButton.onEvent(DigitalInputEventHandler::bind<GestureRecognizer, &GestureRecognizer::handleEvent>(&modeGestures));
+
+#ifdef FRAME_SINK
+  neoPixel.setClock(frameClock);
+#endif
+
+#ifdef OUTPUT_BENCHMARK
+  runOutputBenchmark(NEOPIXEL_CONTROL_PIN);
+#endif
 
   neoPixel.begin();
-  neoPixel.setColor(colorInput.getRedValue(), colorInput.getGreenValue(), colorInput.getBlueValue());
+
+#ifdef FRAME_SINK
+  // The same settings the host goldens are rendered with
+  neoPixel.stopPlaylist();
+  neoPixel.setBrightness(FRAME_SINK_BRIGHTNESS);
+  neoPixel.setColor(FRAME_SINK_RED, FRAME_SINK_GREEN, FRAME_SINK_BLUE);
+  neoPixel.setMode((NeoPixelMode) FRAME_SINK_MODE);
+#else
+  neoPixel.setLinearColor(colorInput.getRedValue(), colorInput.getGreenValue(), colorInput.getBlueValue());
+#endif
+
+  Serial.begin(115200);
+
+#ifdef FRAME_SINK
+  neoPixel.onFrame(onNeoPixelFrame);
+#endif
+
+#ifdef RENDER_BENCHMARK
+  beginRenderBenchmark(neoPixel);
+#endif
+
+#ifdef SCHEDULING_BENCHMARK
+  beginSchedulingBenchmark(schedulingProfile, neoPixel);
+
+#ifdef ALLOCATION_TRACKER
+  // The synthetic presses take the mode button's place so the soak runs every handler from the interrupt to a mode change
+  getSchedulingEdgeInput().onEvent(DigitalInputEventHandler::bind<GestureRecognizer, &GestureRecognizer::handleEvent>(&modeGestures));
+  modeGestures.setInput(getSchedulingEdgeInput());
+#endif
+#endif
+
+#ifdef ALLOCATION_TRACKER
+  beginAllocationTracker();
+#endif
 }
 
 void loop() {  
-  delay(1000); // Short delay to keep the watchdog happy
-}
+  static uint32_t lastStackReportTime = 0;
 
-void onBrightnessButtonEvent(DigitalInputEvent event) {
-  if (event != DigitalInputEvent::Trigger) {
-    return;
+  if (millis() - lastStackReportTime >= STACK_REPORT_INTERVAL) {
+    lastStackReportTime = millis();
+    reportStackHighWaterMarks();
+  }
+
+  static uint32_t lastGestureReportTime = 0;
+
+  if (millis() - lastGestureReportTime >= GESTURE_REPORT_INTERVAL) {
+    lastGestureReportTime = millis();
+    reportGestureStats();
+  }
+
+#ifdef ALLOCATION_TRACKER
+  static uint32_t lastAllocationReportTime = 0;
+
+  if (millis() - lastAllocationReportTime >= ALLOCATION_TRACKER_INTERVAL) {
+    lastAllocationReportTime = millis();
+    reportAllocations();
+  }
+#endif
+
+#ifdef ANALOG_BENCHMARK
+  static const uint8_t knobPins[] = { RED_PIN, GREEN_PIN, BLUE_PIN };
+  static uint32_t lastAnalogReportTime = 0;
+
+  if (millis() - lastAnalogReportTime >= ANALOG_BENCHMARK_INTERVAL) {
+    lastAnalogReportTime = millis();
+    reportAnalogBenchmark(analogFrontEnd, knobPins, sizeof(knobPins));
+  }
+#endif
+
+#ifdef BANK_BENCHMARK
+  static uint32_t lastBankReportTime = 0;
+
+  if (millis() - lastBankReportTime >= BANK_BENCHMARK_INTERVAL) {
+    lastBankReportTime = millis();
+    reportBankBenchmark();
+  }
+#endif
+
+#ifdef FRAME_SINK
+  static uint32_t lastFrameSinkReportTime = 0;
+
+  if (millis() - lastFrameSinkReportTime >= FRAME_SINK_REPORT_INTERVAL) {
+    lastFrameSinkReportTime = millis();
+    reportFrameSink();
+  }
+#endif
+
+#ifdef OUTPUT_BENCHMARK
+  static uint32_t lastOutputReportTime = 0;
+
+  if (millis() - lastOutputReportTime >= OUTPUT_BENCHMARK_INTERVAL) {
+    lastOutputReportTime = millis();
+    reportOutputBenchmark();
   }
+#endif
+
+#ifdef RENDER_BENCHMARK
+  static uint32_t lastRenderReportTime = 0;
+
+  if (millis() - lastRenderReportTime >= RENDER_BENCHMARK_INTERVAL) {
+    lastRenderReportTime = millis();
+    reportRenderBenchmark(neoPixel);
+  }
+#endif
+
+#ifdef SCHEDULING_BENCHMARK
+  static uint32_t lastBenchmarkReportTime = 0;
+
+  if (millis() - lastBenchmarkReportTime >= SCHEDULING_BENCHMARK_INTERVAL) {
+    lastBenchmarkReportTime = millis();
+    reportSchedulingBenchmark(neoPixel, brightnessButton, modeButton);
+  }
+#endif
+
+  // Ambiguous gestures are confirmed here once the gap after the last press runs out
+  brightnessGestures.poll();
+  modeGestures.poll();
 
-  neoPixel.nextBrightness();
+#ifndef FRAME_SINK
+  serialConsole.poll();
+#endif
+
+  delay(LOOP_INTERVAL); // Short delay to keep the watchdog happy, and short enough for console commands to feel instant
 }
 
 void onColorEvent(uint16_t red, uint16_t green, uint16_t blue) {
-  neoPixel.setColor(red, green, blue);
+  neoPixel.setLinearColor(red, green, blue);
+}
+
+void onNeoPixelFrame(const uint8_t* pixels, uint16_t count) {
+#ifdef FRAME_SINK
+  frameSink.write(pixels, count);
+
+  // Straight on to the next step, the mode task renders it as soon as it is back in its wait
+  frameClock.advance(neoPixel.getWaitMillis());
+#endif
 }
 
-void onModeButtonEvent(DigitalInputEvent event) {
-  if (event != DigitalInputEvent::Trigger) {
+void reportFrameSink() {
+#ifdef FRAME_SINK
+  static uint32_t lastFrameCount = 0;
+
+  // Only the checksum format leaves the serial port free for a report
+  if ((FrameSinkFormat) FRAME_SINK != FrameSinkFormat::Checksum) {
     return;
   }
-  
-  neoPixel.nextMode();
+
+  uint32_t frameCount = frameSink.getFrameCount();
+
+  log_w("Frame sink: %u frames (%u fps), checksum %08x, last frame %08x",
+    frameCount,
+    (frameCount - lastFrameCount) * 1000 / FRAME_SINK_REPORT_INTERVAL,
+    frameSink.getChecksum(),
+    frameSink.getLastFrameChecksum());
+
+  lastFrameCount = frameCount;
+#endif
+}
+
+void reportGestureStats() {
+  GestureRecognizerStats brightnessStats = brightnessGestures.getStats();
+  GestureRecognizerStats modeStats = modeGestures.getStats();
+  uint32_t confirmations = brightnessStats.confirmations + modeStats.confirmations;
+
+  // Decision latency is from the raw edge that started the deciding press to the gesture being confirmed
+  log_i("Gestures: %u confirmed, %u cancelled, decision avg %u ms max %u ms",
+    confirmations,
+    brightnessStats.cancellations + modeStats.cancellations,
+    confirmations > 0 ? (brightnessStats.totalDecisionMillis + modeStats.totalDecisionMillis) / confirmations : 0,
+    max(brightnessStats.maxDecisionMillis, modeStats.maxDecisionMillis));
+
+  brightnessGestures.resetStats();
+  modeGestures.resetStats();
+}
+
+void reportStackHighWaterMarks() {
+  // Unused stack in bytes for each task, the *_TASK_STACK_SIZE defines can be reduced to match
+  log_i("Stack high water marks: brightness %d, color %d, mode %d, neopixel %d",
+    brightnessButton.getStackHighWaterMark(),
+    colorInput.getStackHighWaterMark(),
+    modeButton.getStackHighWaterMark(),
+    neoPixel.getStackHighWaterMark());
 }
\ No newline at end of file
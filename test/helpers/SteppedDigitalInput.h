@@ -0,0 +1,67 @@
+#ifndef EMILYS_NEOPIXEL_TEST_STEPPED_DIGITAL_INPUT_H
+#define EMILYS_NEOPIXEL_TEST_STEPPED_DIGITAL_INPUT_H
+
+// A DigitalInput whose task loop is run by the test instead of FreeRTOS, woken the same way: by a notification from
+// the debounce timer or by the timeout it asked for last time round
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "Clock.h"
+#include "DigitalInput.h"
+
+class SteppedDigitalInput : public DigitalInput {
+  public:
+    using DigitalInput::DigitalInput;
+
+    TaskHandle_t getTask() {
+      return _inputTask;
+    }
+
+    // When the task's timeout runs out, false while only a notification can wake it
+    bool getWakeTime(uint32_t& time) {
+      time = _wakeTime;
+      return _ticksToWait != portMAX_DELAY;
+    }
+
+    // One pass of the task loop if it would have been woken by now, returns whether it ran
+    bool step() {
+      bool timedOut = _ticksToWait != portMAX_DELAY && (int32_t) (_clock->getMillis() - _wakeTime) >= 0;
+
+      if (!Host::takeNotification(_inputTask) && !timedOut) {
+        return false;
+      }
+
+      _stats.wakeups++;
+      _handleInput();
+      wait();
+      return true;
+    }
+
+    // Blocks the task the way xTaskNotifyWait would, step() does it after every pass and a test after begin()
+    void wait() {
+      _ticksToWait = _getTicksToWait();
+      _wakeTime = _clock->getMillis() + _ticksToWait;
+    }
+
+  private:
+    TickType_t _ticksToWait = portMAX_DELAY;
+    uint32_t _wakeTime = 0;
+};
+
+typedef void (*SteppedCallback)();
+
+// Moves the clock on a millisecond at a time, firing the timers that are due and running the input's task if it
+// would wake, then whatever else the test runs every millisecond
+inline void runFor(VirtualClock& clock, SteppedDigitalInput& input, uint32_t durationMillis, SteppedCallback everyMillisecond = NULL) {
+  for (uint32_t i = 0; i < durationMillis; i++) {
+    clock.advance(1);
+    Host::runTimers();
+    input.step();
+
+    if (everyMillisecond != NULL) {
+      everyMillisecond();
+    }
+  }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,238 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_ADAFRUIT_NEOPIXEL_H
+#define EMILYS_NEOPIXEL_SHIM_ADAFRUIT_NEOPIXEL_H
+
+// The parts of Adafruit_NeoPixel the effects use, with the library's own math so host frames match the device.
+// Nothing is ever sent, NeoPixel hands getPixels() to NeoPixelOutput
+
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+typedef uint16_t neoPixelType;
+
+class Adafruit_NeoPixel {
+  public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800) {
+      (void) pin;
+
+      _wOffset = (type >> 6) & 0b11;
+      _rOffset = (type >> 4) & 0b11;
+      _gOffset = (type >> 2) & 0b11;
+      _bOffset = type & 0b11;
+
+      _numLEDs = n;
+      _numBytes = n * ((_wOffset == _rOffset) ? 3 : 4);
+      _pixels = (uint8_t *) calloc(_numBytes, 1);
+    }
+
+    ~Adafruit_NeoPixel() {
+      free(_pixels);
+    }
+
+    Adafruit_NeoPixel(const Adafruit_NeoPixel&) = delete;
+    Adafruit_NeoPixel& operator=(const Adafruit_NeoPixel&) = delete;
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+      return ((uint32_t) r << 16) | ((uint32_t) g << 8) | b;
+    }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+      return ((uint32_t) w << 24) | ((uint32_t) r << 16) | ((uint32_t) g << 8) | b;
+    }
+
+    static uint32_t ColorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255) {
+      uint8_t r, g, b;
+
+      hue = (hue * 1530L + 32768) / 65536;
+
+      if (hue < 510) {
+        b = 0;
+
+        if (hue < 255) {
+          r = 255;
+          g = hue;
+        } else {
+          r = 510 - hue;
+          g = 255;
+        }
+      } else if (hue < 1020) {
+        r = 0;
+
+        if (hue < 765) {
+          g = 255;
+          b = hue - 510;
+        } else {
+          g = 1020 - hue;
+          b = 255;
+        }
+      } else if (hue < 1530) {
+        g = 0;
+
+        if (hue < 1275) {
+          r = hue - 1020;
+          b = 255;
+        } else {
+          r = 255;
+          b = 1530 - hue;
+        }
+      } else {
+        r = 255;
+        g = b = 0;
+      }
+
+      uint32_t v1 = 1 + val;
+      uint16_t s1 = 1 + sat;
+      uint8_t s2 = 255 - sat;
+
+      return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+        (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+        (((((b * s1) >> 8) + s2) * v1) >> 8);
+    }
+
+    static uint8_t gamma8(uint8_t x) {
+      static const uint8_t GAMMA_TABLE[256] = {
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,
+        1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,
+        3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,   6,   6,   6,   7,
+        7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  10,  11,  11,  11,  12,  12,
+       13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,
+       20,  21,  21,  22,  22,  23,  24,  24,  25,  25,  26,  27,  27,  28,  29,  29,
+       30,  31,  31,  32,  33,  34,  34,  35,  36,  37,  38,  38,  39,  40,  41,  42,
+       42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,
+       58,  59,  60,  61,  62,  63,  64,  65,  66,  68,  69,  70,  71,  72,  73,  75,
+       76,  77,  78,  80,  81,  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,
+       97,  99, 100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120,
+      122, 124, 125, 127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148,
+      150, 152, 154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180,
+      182, 184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+      218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252, 255
+      };
+
+      return GAMMA_TABLE[x];
+    }
+
+    static uint32_t gamma32(uint32_t x) {
+      uint8_t *y = (uint8_t *) &x;
+
+      for (uint8_t i = 0; i < 4; i++) {
+        y[i] = gamma8(y[i]);
+      }
+
+      return x;
+    }
+
+    void begin() {
+    }
+
+    void clear() {
+      memset(_pixels, 0, _numBytes);
+    }
+
+    void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0) {
+      uint16_t end;
+
+      if (first >= _numLEDs) {
+        return;
+      }
+
+      if (count == 0) {
+        end = _numLEDs;
+      } else {
+        end = first + count;
+
+        if (end > _numLEDs) {
+          end = _numLEDs;
+        }
+      }
+
+      for (uint16_t i = first; i < end; i++) {
+        setPixelColor(i, c);
+      }
+    }
+
+    uint8_t getBrightness() const {
+      return _brightness - 1;
+    }
+
+    uint8_t* getPixels() const {
+      return _pixels;
+    }
+
+    uint16_t numPixels() const {
+      return _numLEDs;
+    }
+
+    // Rescales what is already in the buffer, lossy just like the library
+    void setBrightness(uint8_t b) {
+      uint8_t newBrightness = b + 1;
+
+      if (newBrightness == _brightness) {
+        return;
+      }
+
+      uint8_t c, *ptr = _pixels, oldBrightness = _brightness - 1;
+      uint16_t scale;
+
+      if (oldBrightness == 0) {
+        scale = 0;
+      } else if (b == 255) {
+        scale = 65535 / oldBrightness;
+      } else {
+        scale = (((uint16_t) newBrightness << 8) - 1) / oldBrightness;
+      }
+
+      for (uint16_t i = 0; i < _numBytes; i++) {
+        c = *ptr;
+        *ptr++ = (c * scale) >> 8;
+      }
+
+      _brightness = newBrightness;
+    }
+
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+      setPixelColor(n, Color(r, g, b));
+    }
+
+    void setPixelColor(uint16_t n, uint32_t c) {
+      if (n >= _numLEDs) {
+        return;
+      }
+
+      uint8_t *p, r = (uint8_t) (c >> 16), g = (uint8_t) (c >> 8), b = (uint8_t) c;
+
+      if (_brightness) {
+        r = (r * _brightness) >> 8;
+        g = (g * _brightness) >> 8;
+        b = (b * _brightness) >> 8;
+      }
+
+      if (_wOffset == _rOffset) {
+        p = &_pixels[n * 3];
+      } else {
+        p = &_pixels[n * 4];
+
+        uint8_t w = (uint8_t) (c >> 24);
+        p[_wOffset] = _brightness ? ((w * _brightness) >> 8) : w;
+      }
+
+      p[_rOffset] = r;
+      p[_gOffset] = g;
+      p[_bOffset] = b;
+    }
+
+    void show() {
+    }
+
+  private:
+    uint8_t _brightness = 0;
+    uint8_t _bOffset;
+    uint8_t _gOffset;
+    uint16_t _numBytes;
+    uint16_t _numLEDs;
+    uint8_t *_pixels;
+    uint8_t _rOffset;
+    uint8_t _wOffset;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,482 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_ARDUINO_H
+#define EMILYS_NEOPIXEL_SHIM_ARDUINO_H
+
+// Just enough of the Arduino core, FreeRTOS and ESP-IDF for the native environment. Tasks are created but never run,
+// a test steps their wait loops itself and can see the notifications that would have woken them
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using std::max;
+using std::min;
+
+#define LOW 0
+#define HIGH 1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+
+#define HOST_ADC1_CHANNELS 8
+#define HOST_MAX_PINS 40
+#define HOST_MAX_TASKS 16
+
+#define configMAX_PRIORITIES 25
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdMS_TO_TICKS(millis) ((TickType_t) (millis))
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+#define portNUM_PROCESSORS 2
+#define portYIELD_FROM_ISR(woken) (void) (woken)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define ESP_OK 0
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef int esp_err_t;
+typedef int gpio_num_t;
+
+typedef enum {
+  eNoAction = 0,
+  eSetBits,
+  eIncrement,
+  eSetValueWithOverwrite,
+  eSetValueWithoutOverwrite
+} eNotifyAction;
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+  ESP_SLEEP_WAKEUP_EXT0 = 2
+} esp_sleep_wakeup_cause_t;
+
+struct HostTask {
+  const char* name;
+  void* args;
+  bool notified;
+  uint32_t notificationValue;
+};
+
+struct HostSemaphore {
+  bool created;
+};
+
+typedef HostTask* TaskHandle_t;
+typedef HostSemaphore* SemaphoreHandle_t;
+
+struct StaticTask_t {
+  HostTask task;
+};
+
+typedef HostSemaphore StaticSemaphore_t;
+
+namespace Host {
+  struct Pin {
+    int level;
+    void (*handler)(void *);
+    void* args;
+  };
+
+  typedef uint32_t (*MillisSource)();
+
+  // ADC1 channel to GPIO, the only ADC the front end uses
+  inline const uint8_t adc1Pins[HOST_ADC1_CHANNELS] = { 36, 37, 38, 39, 32, 33, 34, 35 };
+  inline uint16_t analogLevels[HOST_MAX_PINS] = {};
+  inline uint16_t analogNoise = 0;
+  inline uint32_t analogNoiseSeed = 1;
+
+  // Pins idle high as if pulled up, like the buttons
+  inline Pin pins[HOST_MAX_PINS] = {};
+  inline bool pinsInitialized = false;
+
+  inline TaskHandle_t tasks[HOST_MAX_TASKS] = {};
+
+  inline MillisSource millisSource = nullptr;
+
+  inline uint32_t deepSleeps = 0;
+  inline uint32_t lightSleeps = 0;
+  inline esp_sleep_wakeup_cause_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+  inline bool verbose = false;
+
+  inline Pin& getPin(uint8_t pin) {
+    if (!pinsInitialized) {
+      for (uint8_t i = 0; i < HOST_MAX_PINS; i++) {
+        pins[i].level = HIGH;
+      }
+
+      pinsInitialized = true;
+    }
+
+    return pins[pin % HOST_MAX_PINS];
+  }
+
+  // 12 bit raw reading with up to analogNoise counts either way, from a fixed seed so a run can be repeated
+  inline uint16_t readAnalog(uint8_t pin) {
+    int32_t level = analogLevels[pin % HOST_MAX_PINS];
+
+    if (analogNoise > 0) {
+      analogNoiseSeed = analogNoiseSeed * 1103515245 + 12345;
+      level += (int32_t) ((analogNoiseSeed >> 16) % (2 * analogNoise + 1)) - analogNoise;
+    }
+
+    return (uint16_t) min(max(level, (int32_t) 0), (int32_t) 4095);
+  }
+
+  inline uint64_t getRealMicros() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // A missing or deleted mutex trips configASSERT on the ESP32, so it stops the test here too
+  inline void checkSemaphore(SemaphoreHandle_t semaphore) {
+    if (semaphore == NULL || !semaphore->created) {
+      fprintf(stderr, "Semaphore used before it was created or after it was deleted\n");
+      abort();
+    }
+  }
+
+  inline void log(char level, const char* format, ...) {
+    if (level != 'E' && !verbose) {
+      return;
+    }
+
+    va_list args;
+
+    va_start(args, format);
+    fprintf(stderr, "[%c] ", level);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+  }
+
+  inline void setAnalogLevel(uint8_t pin, uint16_t level) {
+    analogLevels[pin % HOST_MAX_PINS] = level;
+  }
+
+  inline void setAnalogNoise(uint16_t noise) {
+    analogNoise = noise;
+  }
+
+  // millis() follows the source once one is set, so the edge timestamps taken in an interrupt match a VirtualClock
+  inline void setMillisSource(MillisSource source) {
+    millisSource = source;
+  }
+
+  // Drives a pin like the outside world would, the interrupt handler runs straight away on a level change
+  inline void setPinLevel(uint8_t pin, int level) {
+    Pin& hostPin = getPin(pin);
+
+    if (hostPin.level == level) {
+      return;
+    }
+
+    hostPin.level = level;
+
+    if (hostPin.handler != NULL) {
+      hostPin.handler(hostPin.args);
+    }
+  }
+
+  inline TaskHandle_t findTask(const char* name) {
+    for (uint8_t i = 0; i < HOST_MAX_TASKS; i++) {
+      if (tasks[i] != NULL && strcmp(tasks[i]->name, name) == 0) {
+        return tasks[i];
+      }
+    }
+
+    return NULL;
+  }
+
+  // Clears and returns a pending notification the way xTaskNotifyWait would when the task wakes up
+  inline bool takeNotification(TaskHandle_t task, uint32_t* value = NULL) {
+    if (task == NULL || !task->notified) {
+      return false;
+    }
+
+    if (value != NULL) {
+      *value = task->notificationValue;
+    }
+
+    task->notified = false;
+    task->notificationValue = 0;
+
+    return true;
+  }
+}
+
+#define log_d(format, ...) Host::log('D', format, ##__VA_ARGS__)
+#define log_e(format, ...) Host::log('E', format, ##__VA_ARGS__)
+#define log_i(format, ...) Host::log('I', format, ##__VA_ARGS__)
+#define log_w(format, ...) Host::log('W', format, ##__VA_ARGS__)
+
+inline uint32_t millis() {
+  if (Host::millisSource != nullptr) {
+    return Host::millisSource();
+  }
+
+  return (uint32_t) (Host::getRealMicros() / 1000);
+}
+
+// Always real time so the render statistics measure the host's actual work
+inline uint32_t micros() {
+  return (uint32_t) Host::getRealMicros();
+}
+
+inline void delay(uint32_t) {
+}
+
+inline void delayMicroseconds(uint32_t) {
+}
+
+inline void attachInterruptArg(uint8_t pin, void (*handler)(void *), void* args, int) {
+  Host::Pin& hostPin = Host::getPin(pin);
+
+  hostPin.handler = handler;
+  hostPin.args = args;
+}
+
+inline void detachInterrupt(uint8_t pin) {
+  Host::Pin& hostPin = Host::getPin(pin);
+
+  hostPin.handler = NULL;
+  hostPin.args = NULL;
+}
+
+inline uint16_t analogRead(uint8_t pin) {
+  return Host::readAnalog(pin);
+}
+
+inline int8_t digitalPinToAnalogChannel(uint8_t pin) {
+  for (uint8_t i = 0; i < HOST_ADC1_CHANNELS; i++) {
+    if (Host::adc1Pins[i] == pin) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+inline int digitalRead(uint8_t pin) {
+  return Host::getPin(pin).level;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+  Host::setPinLevel(pin, level);
+}
+
+inline void pinMode(uint8_t, uint8_t) {
+}
+
+inline int64_t esp_timer_get_time() {
+  return (int64_t) Host::getRealMicros();
+}
+
+inline esp_err_t esp_deep_sleep_start() {
+  // Never returns on the ESP32, a test checks Host::deepSleeps and boots again itself
+  Host::deepSleeps++;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_light_sleep_start() {
+  Host::lightSleeps++;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int) {
+  return ESP_OK;
+}
+
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  return Host::wakeupCause;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+  buffer->created = true;
+  return buffer;
+}
+
+// Nothing runs concurrently on the host so the locks never have to wait
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  Host::checkSemaphore(semaphore);
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t) {
+  Host::checkSemaphore(semaphore);
+  return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  if (semaphore != NULL) {
+    semaphore->created = false;
+  }
+}
+
+inline TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t, const char* name, uint32_t, void* args, UBaseType_t, StackType_t*, StaticTask_t* buffer, BaseType_t) {
+  for (uint8_t i = 0; i < HOST_MAX_TASKS; i++) {
+    if (Host::tasks[i] == NULL) {
+      buffer->task = { name, args, false, 0 };
+      Host::tasks[i] = &buffer->task;
+      return Host::tasks[i];
+    }
+  }
+
+  return NULL;
+}
+
+inline void vTaskDelete(TaskHandle_t task) {
+  for (uint8_t i = 0; i < HOST_MAX_TASKS; i++) {
+    if (task != NULL && Host::tasks[i] == task) {
+      Host::tasks[i] = NULL;
+    }
+  }
+}
+
+inline BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  if (task == NULL) {
+    return pdFALSE;
+  }
+
+  switch (action)
+  {
+    case eSetBits: {
+      task->notificationValue |= value;
+      break;
+    }
+    case eIncrement: {
+      task->notificationValue++;
+      break;
+    }
+    case eSetValueWithOverwrite: {
+      task->notificationValue = value;
+      break;
+    }
+    case eSetValueWithoutOverwrite: {
+      if (task->notified) {
+        return pdFALSE;
+      }
+
+      task->notificationValue = value;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+
+  task->notified = true;
+  return pdPASS;
+}
+
+inline BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* higherPriorityTaskWoken) {
+  if (higherPriorityTaskWoken != NULL) {
+    *higherPriorityTaskWoken = pdFALSE;
+  }
+
+  return xTaskNotify(task, value, action);
+}
+
+// Only reached from task code, which never runs on the host
+inline BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t*, TickType_t) {
+  return pdFALSE;
+}
+
+inline void vTaskDelayUntil(TickType_t*, TickType_t) {
+}
+
+inline TickType_t xTaskGetTickCount() {
+  return millis();
+}
+
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 0;
+}
+
+class Print {
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+      size_t written = 0;
+
+      while (size-- > 0) {
+        written += write(*buffer++);
+      }
+
+      return written;
+    }
+
+    size_t print(const char* text) {
+      return write((const uint8_t*) text, strlen(text));
+    }
+
+    virtual int availableForWrite() {
+      return 0;
+    }
+
+    // Like the ESP32 core: formatted on the stack when it fits in 64 bytes, through malloc when it doesn't
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+      char buffer[64];
+      char* text = buffer;
+      va_list args;
+
+      va_start(args, format);
+      int length = vsnprintf(buffer, sizeof(buffer), format, args);
+      va_end(args);
+
+      if (length < 0) {
+        return 0;
+      }
+
+      if ((size_t) length >= sizeof(buffer)) {
+        text = (char*) malloc(length + 1);
+
+        if (text == NULL) {
+          return 0;
+        }
+
+        va_start(args, format);
+        vsnprintf(text, length + 1, format, args);
+        va_end(args);
+      }
+
+      size_t written = write((const uint8_t*) text, length);
+
+      if (text != buffer) {
+        free(text);
+      }
+
+      return written;
+    }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+#endif
\ No newline at end of file
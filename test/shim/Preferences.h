@@ -0,0 +1,122 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_PREFERENCES_H
+#define EMILYS_NEOPIXEL_SHIM_PREFERENCES_H
+
+// NVS stand-in, the storage outlives any one Preferences object so a test can reboot and read it back
+
+#include <Arduino.h>
+
+#define HOST_PREFERENCES_MAX_ENTRIES 16
+#define HOST_PREFERENCES_MAX_KEY 16
+#define HOST_PREFERENCES_MAX_LENGTH 256
+
+namespace Host {
+  struct PreferencesEntry {
+    bool used;
+    char key[HOST_PREFERENCES_MAX_KEY];
+    uint8_t data[HOST_PREFERENCES_MAX_LENGTH];
+    size_t length;
+  };
+
+  inline PreferencesEntry preferences[HOST_PREFERENCES_MAX_ENTRIES] = {};
+  inline uint32_t preferencesReads = 0;
+  inline uint32_t preferencesWrites = 0;
+
+  inline void clearPreferences() {
+    memset(preferences, 0, sizeof(preferences));
+    preferencesReads = 0;
+    preferencesWrites = 0;
+  }
+}
+
+class Preferences {
+  public:
+    bool begin(const char*, bool = false) {
+      return true;
+    }
+
+    void end() {
+    }
+
+    size_t getBytes(const char* key, void* buffer, size_t maxLength) {
+      Host::PreferencesEntry* entry = _find(key);
+
+      Host::preferencesReads++;
+
+      if (entry == NULL || buffer == NULL || entry->length > maxLength) {
+        return 0;
+      }
+
+      memcpy(buffer, entry->data, entry->length);
+      return entry->length;
+    }
+
+    size_t getBytesLength(const char* key) {
+      Host::PreferencesEntry* entry = _find(key);
+
+      Host::preferencesReads++;
+
+      return (entry == NULL) ? 0 : entry->length;
+    }
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) {
+      Host::PreferencesEntry* entry = _find(key);
+
+      Host::preferencesReads++;
+
+      return (entry == NULL || entry->length != 1) ? defaultValue : entry->data[0];
+    }
+
+    // Like NVS a zero length write is refused and leaves the old value in place
+    size_t putBytes(const char* key, const void* value, size_t length) {
+      if (key == NULL || value == NULL || length == 0 || length > HOST_PREFERENCES_MAX_LENGTH || strlen(key) >= HOST_PREFERENCES_MAX_KEY) {
+        return 0;
+      }
+
+      Host::PreferencesEntry* entry = _find(key);
+
+      for (uint8_t i = 0; entry == NULL && i < HOST_PREFERENCES_MAX_ENTRIES; i++) {
+        if (!Host::preferences[i].used) {
+          entry = &Host::preferences[i];
+          entry->used = true;
+          strcpy(entry->key, key);
+        }
+      }
+
+      if (entry == NULL) {
+        return 0;
+      }
+
+      memcpy(entry->data, value, length);
+      entry->length = length;
+      Host::preferencesWrites++;
+
+      return length;
+    }
+
+    size_t putUChar(const char* key, uint8_t value) {
+      return putBytes(key, &value, sizeof(value));
+    }
+
+    bool remove(const char* key) {
+      Host::PreferencesEntry* entry = _find(key);
+
+      if (entry == NULL) {
+        return false;
+      }
+
+      memset(entry, 0, sizeof(*entry));
+      return true;
+    }
+
+  private:
+    Host::PreferencesEntry* _find(const char* key) {
+      for (uint8_t i = 0; key != NULL && i < HOST_PREFERENCES_MAX_ENTRIES; i++) {
+        if (Host::preferences[i].used && strcmp(Host::preferences[i].key, key) == 0) {
+          return &Host::preferences[i];
+        }
+      }
+
+      return NULL;
+    }
+};
+#endif
\ No newline at end of file
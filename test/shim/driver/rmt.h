@@ -0,0 +1,90 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_DRIVER_RMT_H
+#define EMILYS_NEOPIXEL_SHIM_DRIVER_RMT_H
+
+// Legacy RMT driver stand-in, every transfer completes the moment it is written
+
+#include <Arduino.h>
+
+typedef enum {
+  RMT_CHANNEL_0 = 0,
+  RMT_CHANNEL_1,
+  RMT_CHANNEL_2,
+  RMT_CHANNEL_3,
+  RMT_CHANNEL_4,
+  RMT_CHANNEL_5,
+  RMT_CHANNEL_6,
+  RMT_CHANNEL_7,
+  RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef struct {
+  union {
+    struct {
+      uint32_t duration0 : 15;
+      uint32_t level0 : 1;
+      uint32_t duration1 : 15;
+      uint32_t level1 : 1;
+    };
+    uint32_t val;
+  };
+} rmt_item32_t;
+
+typedef struct {
+  rmt_channel_t channel;
+  gpio_num_t gpio_num;
+  uint8_t clk_div;
+} rmt_config_t;
+
+typedef void (*rmt_tx_end_fn_t)(rmt_channel_t channel, void *args);
+
+typedef struct {
+  rmt_tx_end_fn_t function;
+  void *arg;
+} rmt_tx_end_callback_t;
+
+namespace Host {
+  inline int rmtItemCounts[RMT_CHANNEL_MAX] = {};
+  inline rmt_tx_end_callback_t rmtTxEndCallback = {};
+  inline uint32_t rmtWrites = 0;
+
+  inline rmt_config_t getRmtConfig(gpio_num_t pin, rmt_channel_t channel) {
+    return { channel, pin, 80 };
+  }
+}
+
+#define RMT_DEFAULT_CONFIG_TX(pin, channel) Host::getRmtConfig(pin, channel)
+
+inline esp_err_t rmt_config(const rmt_config_t*) {
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_driver_install(rmt_channel_t, size_t, int) {
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_driver_uninstall(rmt_channel_t) {
+  return ESP_OK;
+}
+
+inline rmt_tx_end_callback_t rmt_register_tx_end_callback(rmt_tx_end_fn_t function, void *arg) {
+  rmt_tx_end_callback_t previous = Host::rmtTxEndCallback;
+
+  Host::rmtTxEndCallback = { function, arg };
+  return previous;
+}
+
+inline esp_err_t rmt_wait_tx_done(rmt_channel_t, TickType_t) {
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t*, int item_num, bool) {
+  Host::rmtItemCounts[channel] = item_num;
+  Host::rmtWrites++;
+
+  if (Host::rmtTxEndCallback.function != NULL) {
+    Host::rmtTxEndCallback.function(channel, Host::rmtTxEndCallback.arg);
+  }
+
+  return ESP_OK;
+}
+#endif
\ No newline at end of file
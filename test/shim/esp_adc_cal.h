@@ -0,0 +1,33 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_ESP_ADC_CAL_H
+#define EMILYS_NEOPIXEL_SHIM_ESP_ADC_CAL_H
+
+// A straight line over the 11 dB range in place of the eFuse calibration curve
+
+#include <Arduino.h>
+#include <driver/adc.h>
+
+#define HOST_ADC_CAL_MAX_MILLIVOLTS 2450
+#define HOST_ADC_CAL_MIN_MILLIVOLTS 150
+
+typedef enum {
+  ESP_ADC_CAL_VAL_EFUSE_VREF = 0,
+  ESP_ADC_CAL_VAL_EFUSE_TP = 1,
+  ESP_ADC_CAL_VAL_DEFAULT_VREF = 2
+} esp_adc_cal_value_t;
+
+typedef struct {
+  adc_unit_t adc_num;
+  adc_atten_t atten;
+  adc_bits_width_t bit_width;
+  uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+inline esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width, uint32_t vref, esp_adc_cal_characteristics_t* characteristics) {
+  *characteristics = { unit, atten, width, vref };
+  return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+inline uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t*) {
+  return HOST_ADC_CAL_MIN_MILLIVOLTS + raw * (HOST_ADC_CAL_MAX_MILLIVOLTS - HOST_ADC_CAL_MIN_MILLIVOLTS) / 4095;
+}
+#endif
\ No newline at end of file
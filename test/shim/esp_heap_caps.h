@@ -0,0 +1,18 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_ESP_HEAP_CAPS_H
+#define EMILYS_NEOPIXEL_SHIM_ESP_HEAP_CAPS_H
+
+// The host has one kind of memory, every capability comes from the same heap
+
+#include <Arduino.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void heap_caps_free(void* pointer) {
+  free(pointer);
+}
+
+inline void* heap_caps_malloc(size_t size, uint32_t) {
+  return malloc(size);
+}
+#endif
\ No newline at end of file
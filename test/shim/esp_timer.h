@@ -0,0 +1,104 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_ESP_TIMER_H
+#define EMILYS_NEOPIXEL_SHIM_ESP_TIMER_H
+
+// One-shot esp_timer stand-in on millis(), a test fires the timers that are due with Host::runTimers() as it moves
+// its clock on
+
+#include <Arduino.h>
+
+#define HOST_MAX_TIMERS 8
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+  ESP_TIMER_TASK
+} esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void* arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct HostTimer {
+  bool created;
+  bool active;
+  uint32_t expiryTime;
+  esp_timer_cb_t callback;
+  void* arg;
+};
+
+typedef HostTimer* esp_timer_handle_t;
+
+namespace Host {
+  inline HostTimer timers[HOST_MAX_TIMERS] = {};
+
+  // The earliest expiry of a running timer, false when none is running
+  inline bool getNextTimerTime(uint32_t& time) {
+    bool found = false;
+
+    for (HostTimer& timer : timers) {
+      if (timer.active && (!found || (int32_t) (timer.expiryTime - time) < 0)) {
+        time = timer.expiryTime;
+        found = true;
+      }
+    }
+
+    return found;
+  }
+
+  // Fires every timer that is due, returns whether any did
+  inline bool runTimers() {
+    bool ran = false;
+
+    for (HostTimer& timer : timers) {
+      if (timer.active && (int32_t) (timer.expiryTime - millis()) <= 0) {
+        timer.active = false;
+        timer.callback(timer.arg);
+        ran = true;
+      }
+    }
+
+    return ran;
+  }
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+  for (HostTimer& timer : Host::timers) {
+    if (!timer.created) {
+      timer = { true, false, 0, args->callback, args->arg };
+      *handle = &timer;
+      return ESP_OK;
+    }
+  }
+
+  return ESP_ERR_NO_MEM;
+}
+
+inline esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  *timer = {};
+  return ESP_OK;
+}
+
+// Whole milliseconds on the host, rounded up so a timer never fires before its time
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutMicros) {
+  if (timer->active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  timer->active = true;
+  timer->expiryTime = millis() + (uint32_t) ((timeoutMicros + 999) / 1000);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  timer->active = false;
+  return ESP_OK;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_SOC_GPIO_REG_H
+#define EMILYS_NEOPIXEL_SHIM_SOC_GPIO_REG_H
+
+// GPIO input registers stand-in, reading one packs the levels the test set on its pins like the hardware does
+
+#include <Arduino.h>
+
+#define GPIO_IN_REG 0x3FF4403C
+#define GPIO_IN1_REG 0x3FF44040
+#define GPIO_IN1_DATA 0x000000FF
+
+#define REG_READ(reg) Host::readGpioRegister(reg)
+
+namespace Host {
+  // GPIO0-31 in the first register, GPIO32-39 in the low bits of the second
+  inline uint32_t readGpioRegister(uint32_t reg) {
+    uint8_t first = (reg == GPIO_IN1_REG) ? 32 : 0;
+    uint32_t levels = 0;
+
+    for (uint8_t pin = first; pin < HOST_MAX_PINS && pin < first + 32; pin++) {
+      if (getPin(pin).level != LOW) {
+        levels |= 1UL << (pin - first);
+      }
+    }
+
+    return levels;
+  }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef EMILYS_NEOPIXEL_SHIM_SOC_SOC_CAPS_H
+#define EMILYS_NEOPIXEL_SHIM_SOC_SOC_CAPS_H
+
+// The ESP32's GPIO count, the same as the pins the host keeps levels for
+
+#include <Arduino.h>
+
+#define SOC_GPIO_PIN_COUNT HOST_MAX_PINS
+#endif
\ No newline at end of file
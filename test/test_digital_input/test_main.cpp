@@ -0,0 +1,175 @@
+// Steps one input task loop on a VirtualClock to check when the debounce timer wakes it and when it leaves it to its
+// timeout
+
+#include <unity.h>
+
+#include "Clock.h"
+#include "DigitalInput.h"
+#include "SteppedDigitalInput.h"
+
+#define DIGITAL_INPUT_TEST_BOUNCE_EDGES 5
+#define DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW 20
+#define DIGITAL_INPUT_TEST_EVENT_COUNT 4
+#define DIGITAL_INPUT_TEST_LONG_TRIGGER_WINDOW 1000
+#define DIGITAL_INPUT_TEST_PIN 26
+#define DIGITAL_INPUT_TEST_PRESSES 10
+
+static VirtualClock virtualClock = VirtualClock(1000);
+static SteppedDigitalInput input = SteppedDigitalInput(DIGITAL_INPUT_TEST_PIN);
+static uint32_t events[DIGITAL_INPUT_TEST_EVENT_COUNT];
+static uint32_t eventTimes[DIGITAL_INPUT_TEST_EVENT_COUNT];
+
+static uint32_t getVirtualMillis() {
+  return virtualClock.getMillis();
+}
+
+static void onInputEvent(DigitalInputEvent event) {
+  events[(uint8_t) event]++;
+  eventTimes[(uint8_t) event] = virtualClock.getMillis();
+}
+
+static void runFor(uint32_t durationMillis) {
+  runFor(virtualClock, input, durationMillis);
+}
+
+static void setPressed(bool pressed) {
+  Host::setPinLevel(DIGITAL_INPUT_TEST_PIN, pressed ? LOW : HIGH);
+}
+
+// The contacts chatter for a few milliseconds, well inside the debounce window, before they stay put
+static void bounce(bool pressed) {
+  for (uint8_t i = 0; i < DIGITAL_INPUT_TEST_BOUNCE_EDGES; i++) {
+    setPressed((i % 2 == 0) ? pressed : !pressed);
+    runFor(1);
+  }
+}
+
+void setUp() {
+  memset(events, 0, sizeof(events));
+  memset(eventTimes, 0, sizeof(eventTimes));
+  input.resetStats();
+}
+
+void tearDown() {
+}
+
+void test_release_wakes_a_long_trigger_wait() {
+  setPressed(true);
+  runFor(100);
+
+  uint32_t wakeTime;
+
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::Trigger]);
+  TEST_ASSERT_TRUE(input.getWakeTime(wakeTime));
+  TEST_ASSERT_GREATER_THAN_UINT32(DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW, wakeTime - virtualClock.getMillis());
+
+  // Well before the long trigger is due, the debounce timer has to wake the task once the release has settled
+  uint32_t releaseTime = virtualClock.getMillis();
+
+  setPressed(false);
+
+  TEST_ASSERT_FALSE(Host::takeNotification(input.getTask()));
+  runFor(DIGITAL_INPUT_TEST_LONG_TRIGGER_WINDOW);
+
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_EQUAL_UINT32(0, events[(uint8_t) DigitalInputEvent::LongTrigger]);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(releaseTime + DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW + 1, eventTimes[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, input.getStats().maxLatency);
+}
+
+void test_two_presses_are_two_pairs() {
+  for (uint8_t i = 0; i < 2; i++) {
+    setPressed(true);
+    runFor(100);
+    setPressed(false);
+    runFor(100);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(2, events[(uint8_t) DigitalInputEvent::Trigger]);
+  TEST_ASSERT_EQUAL_UINT32(2, events[(uint8_t) DigitalInputEvent::Release]);
+}
+
+void test_bounce_does_not_wake() {
+  setPressed(true);
+  setPressed(false);
+  setPressed(true);
+
+  // Every edge restarts the debounce timer, only the quiet window after the last one wakes the task
+  TEST_ASSERT_FALSE(Host::takeNotification(input.getTask()));
+
+  runFor(DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW - 1);
+  TEST_ASSERT_EQUAL_UINT32(0, input.getStats().wakeups);
+
+  runFor(100);
+  setPressed(false);
+  runFor(100);
+
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::Trigger]);
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_EQUAL_UINT32(4, input.getStats().edges);
+  TEST_ASSERT_EQUAL_UINT32(2, input.getStats().wakeups);
+}
+
+void test_bouncy_presses_wake_once_per_transition() {
+  for (uint8_t i = 0; i < DIGITAL_INPUT_TEST_PRESSES; i++) {
+    bounce(true);
+    runFor(100);
+    bounce(false);
+    runFor(100);
+  }
+
+  // A glitch shorter than the window settles back where it was and wakes nothing
+  setPressed(true);
+  runFor(DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW / 4);
+  setPressed(false);
+  runFor(100);
+
+  DigitalInputStats stats = input.getStats();
+  uint32_t transitions = events[(uint8_t) DigitalInputEvent::Trigger] + events[(uint8_t) DigitalInputEvent::Release];
+
+  TEST_ASSERT_EQUAL_UINT32(2 * DIGITAL_INPUT_TEST_PRESSES, transitions);
+  TEST_ASSERT_EQUAL_UINT32(2 * DIGITAL_INPUT_TEST_PRESSES * DIGITAL_INPUT_TEST_BOUNCE_EDGES + 2, stats.edges);
+  TEST_ASSERT_EQUAL_UINT32(transitions, stats.wakeups);
+  TEST_ASSERT_EQUAL_UINT32(transitions, stats.latencySamples);
+}
+
+void test_long_trigger_fires_while_held() {
+  setPressed(true);
+  runFor(DIGITAL_INPUT_TEST_LONG_TRIGGER_WINDOW + 100);
+
+  uint32_t triggerTime = eventTimes[(uint8_t) DigitalInputEvent::Trigger];
+
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::LongTrigger]);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(triggerTime + DIGITAL_INPUT_TEST_LONG_TRIGGER_WINDOW + 1, eventTimes[(uint8_t) DigitalInputEvent::LongTrigger]);
+
+  setPressed(false);
+  runFor(100);
+
+  TEST_ASSERT_EQUAL_UINT32(1, events[(uint8_t) DigitalInputEvent::Release]);
+
+  // The long trigger is an event but not a transition, an average over events would be diluted by it
+  DigitalInputStats stats = input.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(3, stats.events);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.latencySamples);
+}
+
+int main() {
+  Host::setMillisSource(getVirtualMillis);
+
+  input.setClock(virtualClock);
+  input.setDebounce(DIGITAL_INPUT_TEST_DEBOUNCE_WINDOW);
+  input.setLongTrigger(DIGITAL_INPUT_TEST_LONG_TRIGGER_WINDOW);
+  // Registered before begin() on purpose, the lock has to exist from the constructor on
+  input.onEvent(onInputEvent);
+  input.begin();
+  input.wait();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_release_wakes_a_long_trigger_wait);
+  RUN_TEST(test_two_presses_are_two_pairs);
+  RUN_TEST(test_bounce_does_not_wake);
+  RUN_TEST(test_bouncy_presses_wake_once_per_transition);
+  RUN_TEST(test_long_trigger_fires_while_held);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+// Renders every mode on a VirtualClock, one step per frame, and checks each frame against the goldens next to this
+// file. Run with FRAME_SINK_UPDATE_GOLDEN=1 to write them again after an intended change to an effect
+
+#include <chrono>
+#include <unity.h>
+
+#include "Clock.h"
+#include "FrameSink.h"
+#include "NeoPixel.h"
+
+#define FRAME_SINK_TEST_BUFFER_SIZE 1024
+#define FRAME_SINK_TEST_FRAMES 256
+#define FRAME_SINK_TEST_MIN_FPS 1000
+#define FRAME_SINK_TEST_PATH_SIZE 256
+#define FRAME_SINK_TEST_PIN 32
+
+class BufferPrint : public Print {
+  public:
+    uint8_t buffer[FRAME_SINK_TEST_BUFFER_SIZE];
+    size_t length = 0;
+
+    size_t write(uint8_t c) override {
+      if (length >= sizeof(buffer)) {
+        return 0;
+      }
+
+      buffer[length++] = c;
+      return 1;
+    }
+};
+
+class NullPrint : public Print {
+  public:
+    size_t write(uint8_t) override {
+      return 1;
+    }
+};
+
+static NullPrint nullPrint;
+static NeoPixel neoPixel = NeoPixel(FRAME_SINK_TEST_PIN);
+static FrameSink frameSink = FrameSink(nullPrint, NEOPIXEL_LED_COLS, NEOPIXEL_LED_ROWS, FrameSinkFormat::Checksum);
+static VirtualClock virtualClock = VirtualClock();
+
+static void getGoldenPath(char* path, NeoPixelMode mode) {
+  const char* file = __FILE__;
+  const char* separator = strrchr(file, '/');
+  int directoryLength = (separator == NULL) ? 0 : (int) (separator - file + 1);
+
+  snprintf(path, FRAME_SINK_TEST_PATH_SIZE, "%.*sgolden/mode_%02d.txt", directoryLength, file, (int) mode);
+}
+
+static void onFrame(const uint8_t* pixels, uint16_t count) {
+  frameSink.write(pixels, count);
+}
+
+// Same as the frame_sink environment on the device: render, then move the clock straight on to the next step
+static void renderMode(NeoPixelMode mode, uint32_t checksums[]) {
+  neoPixel.setMode(mode);
+
+  for (uint16_t i = 0; i < FRAME_SINK_TEST_FRAMES; i++) {
+    neoPixel.update();
+    checksums[i] = frameSink.getLastFrameChecksum();
+    virtualClock.advance(neoPixel.getWaitMillis());
+  }
+}
+
+static void writeGolden(NeoPixelMode mode, const uint32_t checksums[]) {
+  char path[FRAME_SINK_TEST_PATH_SIZE];
+  getGoldenPath(path, mode);
+
+  FILE* file = fopen(path, "w");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+
+  for (uint16_t i = 0; i < FRAME_SINK_TEST_FRAMES; i++) {
+    fprintf(file, "%08x\n", checksums[i]);
+  }
+
+  fclose(file);
+}
+
+static void checkGolden(NeoPixelMode mode, const uint32_t checksums[]) {
+  char path[FRAME_SINK_TEST_PATH_SIZE];
+  getGoldenPath(path, mode);
+
+  FILE* file = fopen(path, "r");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+
+  for (uint16_t i = 0; i < FRAME_SINK_TEST_FRAMES; i++) {
+    uint32_t expected;
+    char message[FRAME_SINK_TEST_PATH_SIZE + 32];
+
+    snprintf(message, sizeof(message), "%s, frame %d", path, i);
+
+    if (fscanf(file, "%x", &expected) != 1) {
+      fclose(file);
+      TEST_FAIL_MESSAGE(message);
+    }
+
+    if (expected != checksums[i]) {
+      fclose(file);
+      TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected, checksums[i], message);
+    }
+  }
+
+  fclose(file);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_binary_format() {
+  BufferPrint output;
+  FrameSink binarySink = FrameSink(output, 2, 1, FrameSinkFormat::Binary);
+  const uint8_t pixels[] = { 1, 2, 3, 4, 5, 6 };
+
+  binarySink.write(pixels, 2);
+  binarySink.write(pixels, 2);
+
+  // Marker, little endian frame number and byte count, then the GRB bytes as they were on the wire
+  const uint8_t header[] = { FRAME_SINK_FRAME_MARKER, 1, 0, 0, 0, 6, 0 };
+
+  TEST_ASSERT_EQUAL_UINT32(2 * (sizeof(header) + sizeof(pixels)), output.length);
+  TEST_ASSERT_EQUAL_MEMORY(header, output.buffer + sizeof(header) + sizeof(pixels), sizeof(header));
+  TEST_ASSERT_EQUAL_MEMORY(pixels, output.buffer + 2 * sizeof(header) + sizeof(pixels), sizeof(pixels));
+  TEST_ASSERT_EQUAL_UINT32(2, binarySink.getFrameCount());
+}
+
+void test_checksum_format_writes_nothing() {
+  BufferPrint output;
+  FrameSink checksumSink = FrameSink(output, 2, 1, FrameSinkFormat::Checksum);
+  FrameSink binarySink = FrameSink(nullPrint, 2, 1, FrameSinkFormat::Binary);
+  const uint8_t pixels[] = { 1, 2, 3, 4, 5, 6 };
+
+  checksumSink.write(pixels, 2);
+  binarySink.write(pixels, 2);
+
+  TEST_ASSERT_EQUAL_UINT32(0, output.length);
+  TEST_ASSERT_EQUAL_HEX32(binarySink.getChecksum(), checksumSink.getChecksum());
+}
+
+void test_modes_match_goldens() {
+  static uint32_t checksums[FRAME_SINK_TEST_FRAMES];
+  bool updateGolden = getenv("FRAME_SINK_UPDATE_GOLDEN") != NULL;
+  uint32_t frames = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint8_t mode = 0; mode <= NEOPIXEL_MAX_MODE; mode++) {
+    renderMode((NeoPixelMode) mode, checksums);
+    frames += FRAME_SINK_TEST_FRAMES;
+
+    if (updateGolden) {
+      writeGolden((NeoPixelMode) mode, checksums);
+    } else {
+      checkGolden((NeoPixelMode) mode, checksums);
+    }
+  }
+
+  uint64_t elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  uint32_t fps = (uint32_t) (frames * 1000000ULL / max(elapsedMicros, (uint64_t) 1));
+  char message[64];
+
+  snprintf(message, sizeof(message), "%u frames in %u us, %u fps", frames, (uint32_t) elapsedMicros, fps);
+  TEST_MESSAGE(message);
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(FRAME_SINK_TEST_MIN_FPS, fps);
+}
+
+void test_ppm_format() {
+  BufferPrint output;
+  FrameSink ppmSink = FrameSink(output, 2, 1, FrameSinkFormat::Ppm);
+  const uint8_t pixels[] = { 1, 2, 3, 4, 5, 6 };
+
+  ppmSink.write(pixels, 2);
+
+  // GRB on the wire, RGB in the image
+  const char header[] = "P6\n2 1\n255\n";
+  const uint8_t rgb[] = { 2, 1, 3, 5, 4, 6 };
+
+  TEST_ASSERT_EQUAL_UINT32(strlen(header) + sizeof(rgb), output.length);
+  TEST_ASSERT_EQUAL_MEMORY(header, output.buffer, strlen(header));
+  TEST_ASSERT_EQUAL_MEMORY(rgb, output.buffer + strlen(header), sizeof(rgb));
+}
+
+int main() {
+  neoPixel.setClock(virtualClock);
+  neoPixel.onFrame(onFrame);
+  neoPixel.begin();
+  neoPixel.stopPlaylist();
+  neoPixel.setBrightness(FRAME_SINK_BRIGHTNESS);
+  neoPixel.setColor(FRAME_SINK_RED, FRAME_SINK_GREEN, FRAME_SINK_BLUE);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_binary_format);
+  RUN_TEST(test_checksum_format_writes_nothing);
+  RUN_TEST(test_modes_match_goldens);
+  RUN_TEST(test_ppm_format);
+  return UNITY_END();
+}
\ No newline at end of file
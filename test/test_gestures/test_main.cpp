@@ -0,0 +1,225 @@
+// Press traces with contact bounce through a DigitalInput and the mode button's gestures on a VirtualClock. Each
+// trace is checked against the events it should raise, S for Speculate, X for Cancel and C for Confirm followed by
+// the gesture, and against the worst case time from the deciding press on the raw input to the gesture being final
+
+#include <unity.h>
+
+#include "ButtonGestures.h"
+#include "Clock.h"
+#include "DigitalInput.h"
+#include "GestureRecognizer.h"
+#include "NeoPixel.h"
+#include "SteppedDigitalInput.h"
+
+// The same button and windows as main.cpp, the gestures and what they do come from ButtonGestures like there
+#define LOOP_INTERVAL 10
+#define MODE_BUTTON_LONG_TRIGGER_WINDOW 1000
+#define MODE_BUTTON_PIN 26
+#define NEOPIXEL_CONTROL_PIN 32
+
+#define GESTURE_TEST_BOUNCE_EDGES 3
+#define GESTURE_TEST_IDLE_MILLIS 2000
+#define GESTURE_TEST_MAX_PRESSES 4
+#define GESTURE_TEST_MESSAGE_SIZE 128
+#define GESTURE_TEST_TRACE_SIZE 64
+
+// Settling takes the debounce window and up to two more ticks, a gap decision one more loop interval. A short press is
+// decided from when it started, so its hold comes on top
+#define GESTURE_TEST_MAX_DECISION_MILLIS (DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW + 2 + GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW + LOOP_INTERVAL)
+
+// Pressed after a pause since the previous press was let go
+struct GestureTestPress {
+  uint16_t pause;
+  uint16_t hold;
+};
+
+struct GestureTestTrace {
+  const char* name;
+  GestureTestPress presses[GESTURE_TEST_MAX_PRESSES];
+  const char* expected;
+};
+
+static const GestureTestTrace TRACES[] = {
+  { "single", { { 0, 100 } }, "S0 C0" },
+  { "double", { { 0, 80 }, { 150, 80 } }, "S0 X0 S1 C1" },
+  { "two singles", { { 0, 80 }, { GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW + 100, 80 } }, "S0 C0 S0 C0" },
+  { "long", { { 0, 1500 } }, "S0 X0 S2 C2" },
+  { "short then long", { { 0, 80 }, { 150, 1500 } }, "S0 X0 S1 X1 S0 C0 S2 C2" },
+  { "long then short", { { 0, 1500 }, { 150, 80 } }, "S0 X0 S2 C2 S0 C0" },
+  { "triple", { { 0, 80 }, { 150, 80 }, { 150, 80 } }, "S0 X0 S1 C1 S0 C0" }
+};
+
+static VirtualClock virtualClock = VirtualClock(1000);
+static SteppedDigitalInput modeButton = SteppedDigitalInput(MODE_BUTTON_PIN);
+static GestureRecognizer modeGestures = GestureRecognizer(ButtonGestures::MODE_GESTURES, MODE_GESTURE_COUNT);
+static NeoPixel neoPixel = NeoPixel(NEOPIXEL_CONTROL_PIN);
+static ButtonGestures buttonGestures = ButtonGestures(neoPixel);
+
+static bool cancelPlaylistActive = false;
+static NeoPixelMode cancelMode = NeoPixelMode::Off;
+static char trace[GESTURE_TEST_TRACE_SIZE];
+
+static uint32_t getVirtualMillis() {
+  return virtualClock.getMillis();
+}
+
+// Logs every event and hands it on like main.cpp does
+static void onModeGesture(GestureEvent event, uint8_t gesture) {
+  static const char EVENT_NAMES[] = { 'S', 'X', 'C' };
+  size_t length = strlen(trace);
+
+  snprintf(trace + length, sizeof(trace) - length, "%s%c%d", length > 0 ? " " : "", EVENT_NAMES[(uint8_t) event], gesture);
+
+  buttonGestures.handleModeGesture(event, gesture);
+
+  if (event == GestureEvent::Cancel && gesture == MODE_GESTURE_NEXT) {
+    cancelPlaylistActive = neoPixel.isPlaylistActive();
+    cancelMode = neoPixel.getMode();
+  }
+}
+
+// loop() polls the gestures every loop interval
+static void pollGestures() {
+  if (virtualClock.getMillis() % LOOP_INTERVAL == 0) {
+    modeGestures.poll();
+  }
+}
+
+static void runFor(uint32_t durationMillis) {
+  runFor(virtualClock, modeButton, durationMillis, pollGestures);
+}
+
+// Both contacts bounce for a couple of milliseconds
+static void setPressed(bool pressed) {
+  for (uint8_t i = 0; i < GESTURE_TEST_BOUNCE_EDGES; i++) {
+    bool level = (i % 2 == 0) ? pressed : !pressed;
+
+    Host::setPinLevel(MODE_BUTTON_PIN, level ? LOW : HIGH);
+    runFor(1);
+  }
+}
+
+static uint16_t getMaxShortHold(const GestureTestTrace& testTrace) {
+  uint16_t maxHold = 0;
+
+  for (const GestureTestPress& press : testTrace.presses) {
+    if (press.hold < MODE_BUTTON_LONG_TRIGGER_WINDOW) {
+      maxHold = max(maxHold, press.hold);
+    }
+  }
+
+  return maxHold;
+}
+
+static void runTrace(const GestureTestTrace& testTrace) {
+  trace[0] = '\0';
+
+  for (uint8_t i = 0; i < GESTURE_TEST_MAX_PRESSES && testTrace.presses[i].hold > 0; i++) {
+    runFor(testTrace.presses[i].pause);
+    setPressed(true);
+    runFor(testTrace.presses[i].hold);
+    setPressed(false);
+  }
+
+  runFor(GESTURE_TEST_IDLE_MILLIS);
+}
+
+void setUp() {
+  modeGestures.resetStats();
+  neoPixel.stopPlaylist();
+}
+
+void tearDown() {
+}
+
+void test_traces() {
+  uint32_t maxDecisionMillis = 0;
+
+  for (const GestureTestTrace& testTrace : TRACES) {
+    char message[GESTURE_TEST_MESSAGE_SIZE];
+
+    modeGestures.resetStats();
+    runTrace(testTrace);
+
+    GestureRecognizerStats stats = modeGestures.getStats();
+
+    snprintf(message, sizeof(message), "%s: %s, decision max %u ms", testTrace.name, trace, stats.maxDecisionMillis);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_STRING(testTrace.expected, trace);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(GESTURE_TEST_MAX_DECISION_MILLIS + getMaxShortHold(testTrace), stats.maxDecisionMillis, testTrace.name);
+
+    maxDecisionMillis = max(maxDecisionMillis, stats.maxDecisionMillis);
+  }
+
+  // An ambiguous press can only be settled after the whole gap, measured from the edge that includes debouncing
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW + GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW, maxDecisionMillis);
+}
+
+void test_long_press_is_timed_from_the_press() {
+  static const GestureTestTrace longTrace = { "long", { { 0, 1500 } }, "S0 X0 S2 C2" };
+
+  runTrace(longTrace);
+
+  // The press edge plus the long trigger window is when it became a long press, the rest is debouncing
+  uint32_t decision = modeGestures.getStats().maxDecisionMillis;
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW, decision);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW + 2, decision);
+}
+
+void test_double_press_rolls_back_into_the_playlist() {
+  static const GestureTestTrace doubleTrace = { "double", { { 0, 80 }, { 150, 80 } }, "S0 X0 S1 C1" };
+
+  neoPixel.startPlaylist();
+
+  NeoPixelMode playlistMode = neoPixel.getMode();
+
+  cancelPlaylistActive = false;
+  runTrace(doubleTrace);
+
+  // The cancel puts back the playlist the single press stopped, then going back a mode stops it again
+  TEST_ASSERT_EQUAL_STRING(doubleTrace.expected, trace);
+  TEST_ASSERT_TRUE(cancelPlaylistActive);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) playlistMode, (uint8_t) cancelMode);
+  TEST_ASSERT_FALSE(neoPixel.isPlaylistActive());
+}
+
+void test_single_press_leaves_the_playlist() {
+  static const GestureTestTrace singleTrace = { "single", { { 0, 100 } }, "S0 C0" };
+
+  neoPixel.startPlaylist();
+
+  NeoPixelMode playlistMode = neoPixel.getMode();
+
+  runTrace(singleTrace);
+
+  TEST_ASSERT_FALSE(neoPixel.isPlaylistActive());
+  TEST_ASSERT_EQUAL_UINT8(((uint8_t) playlistMode + 1) % (NEOPIXEL_MAX_MODE + 1), (uint8_t) neoPixel.getMode());
+}
+
+int main() {
+  Host::setMillisSource(getVirtualMillis);
+
+  modeGestures.setClock(virtualClock);
+  modeGestures.begin();
+  modeGestures.onEvent(onModeGesture);
+  modeGestures.setInput(modeButton);
+
+  modeButton.setClock(virtualClock);
+  modeButton.setDebounce();
+  modeButton.setLongTrigger(MODE_BUTTON_LONG_TRIGGER_WINDOW);
+  modeButton.begin();
+  modeButton.onEvent(DigitalInputEventHandler::bind<GestureRecognizer, &GestureRecognizer::handleEvent>(&modeGestures));
+  modeButton.wait();
+
+  neoPixel.setClock(virtualClock);
+  neoPixel.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_traces);
+  RUN_TEST(test_long_press_is_timed_from_the_press);
+  RUN_TEST(test_double_press_rolls_back_into_the_playlist);
+  RUN_TEST(test_single_press_leaves_the_playlist);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+// Feeds sampled levels straight into a DigitalInputBank a tick at a time on a VirtualClock, to check the vertical
+// counter debounce and the events it derives for several buttons at once, and times its update for 1, 8 and 32 inputs
+// the way the bank_benchmark environment does on the device
+
+#include <unity.h>
+
+#include "Clock.h"
+#include "DigitalInputBank.h"
+
+#define INPUT_BANK_TEST_BENCHMARK_UPDATES 1000
+#define INPUT_BANK_TEST_LONG_PIN 0
+#define INPUT_BANK_TEST_MESSAGE_SIZE 128
+#define INPUT_BANK_TEST_MULTI_PIN 5
+#define INPUT_BANK_TEST_PLAIN_PIN 33
+#define INPUT_BANK_TEST_TRACE_SIZE 128
+
+#define INPUT_BANK_TEST_BIT(pin) (1ULL << (pin))
+
+static VirtualClock virtualClock = VirtualClock();
+static DigitalInputBank* bank = NULL;
+static char trace[INPUT_BANK_TEST_TRACE_SIZE];
+
+static void onBankEvent(uint8_t pin, DigitalInputEvent event) {
+  static const char EVENT_NAMES[] = { 'R', 'T', 'L', 'M' };
+  size_t length = strlen(trace);
+
+  snprintf(trace + length, sizeof(trace) - length, "%s%c%d", length > 0 ? " " : "", EVENT_NAMES[(uint8_t) event], pin);
+}
+
+// The buttons pull low when pressed, so every pin that is not pressed reads high
+static void tick(uint64_t pressed) {
+  virtualClock.advance(DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS);
+  bank->update(~pressed);
+}
+
+static void hold(uint64_t pressed, uint16_t ticks) {
+  for (uint16_t i = 0; i < ticks; i++) {
+    tick(pressed);
+  }
+}
+
+// The changing pins flip back and forth for a few ticks before they settle at the new levels
+static void bounce(uint64_t from, uint64_t to) {
+  tick(to);
+  tick(from);
+  tick(to);
+  tick(from);
+}
+
+static void addInput(uint8_t pin) {
+  TEST_ASSERT_TRUE(bank->addInput(pin));
+}
+
+void setUp() {
+  bank = new DigitalInputBank();
+  bank->setClock(virtualClock);
+  bank->onEvent(onBankEvent);
+  trace[0] = '\0';
+}
+
+void tearDown() {
+  delete bank;
+  bank = NULL;
+
+  for (uint8_t pin = 0; pin < SOC_GPIO_PIN_COUNT; pin++) {
+    Host::setPinLevel(pin, HIGH);
+  }
+}
+
+void test_four_ticks_make_a_transition() {
+  addInput(INPUT_BANK_TEST_PLAIN_PIN);
+  bank->begin();
+
+  // Three ticks in a row are not enough and one agreeing tick starts the count over
+  hold(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_PLAIN_PIN), DIGITAL_INPUT_BANK_DEBOUNCE_TICKS - 1);
+  tick(0);
+  hold(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_PLAIN_PIN), DIGITAL_INPUT_BANK_DEBOUNCE_TICKS - 1);
+
+  TEST_ASSERT_FALSE(bank->isTriggered(INPUT_BANK_TEST_PLAIN_PIN));
+  TEST_ASSERT_EQUAL_STRING("", trace);
+
+  tick(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_PLAIN_PIN));
+
+  TEST_ASSERT_TRUE(bank->isTriggered(INPUT_BANK_TEST_PLAIN_PIN));
+  TEST_ASSERT_EQUAL_STRING("T33", trace);
+
+  hold(0, DIGITAL_INPUT_BANK_DEBOUNCE_TICKS - 1);
+  TEST_ASSERT_TRUE(bank->isTriggered(INPUT_BANK_TEST_PLAIN_PIN));
+
+  tick(0);
+  TEST_ASSERT_FALSE(bank->isTriggered(INPUT_BANK_TEST_PLAIN_PIN));
+  TEST_ASSERT_EQUAL_STRING("T33 R33", trace);
+}
+
+void test_held_through_begin_does_not_trigger() {
+  addInput(INPUT_BANK_TEST_PLAIN_PIN);
+  addInput(INPUT_BANK_TEST_MULTI_PIN);
+
+  // begin() reads both input registers for the starting state
+  Host::setPinLevel(INPUT_BANK_TEST_PLAIN_PIN, LOW);
+  Host::setPinLevel(INPUT_BANK_TEST_MULTI_PIN, LOW);
+  bank->begin();
+
+  TEST_ASSERT_TRUE(bank->isTriggered(INPUT_BANK_TEST_PLAIN_PIN));
+  TEST_ASSERT_TRUE(bank->isTriggered(INPUT_BANK_TEST_MULTI_PIN));
+
+  hold(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_PLAIN_PIN) | INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN), 10);
+  TEST_ASSERT_EQUAL_STRING("", trace);
+}
+
+void test_events_across_pins() {
+  static const uint64_t both = INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN) | INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_PLAIN_PIN);
+  static const uint64_t longAndMulti = INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_LONG_PIN) | INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN);
+
+  addInput(INPUT_BANK_TEST_LONG_PIN);
+  addInput(INPUT_BANK_TEST_MULTI_PIN);
+  addInput(INPUT_BANK_TEST_PLAIN_PIN);
+  bank->setLongTrigger(INPUT_BANK_TEST_LONG_PIN);
+  bank->setMultiTrigger(INPUT_BANK_TEST_MULTI_PIN);
+  bank->begin();
+
+  TEST_ASSERT_EQUAL_UINT8(3, bank->getInputCount());
+
+  // Two pins pressed together with bounce, then let go one after the other
+  bounce(0, both);
+  hold(both, 10);
+  bounce(both, INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN));
+  hold(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN), 10);
+  bounce(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_MULTI_PIN), 0);
+  hold(0, 10);
+
+  // The second press of the multi trigger pin inside its window, while the long trigger pin is held past its own
+  bounce(0, longAndMulti);
+  hold(longAndMulti, 6);
+  bounce(longAndMulti, INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_LONG_PIN));
+  hold(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_LONG_PIN), DIGITAL_INPUT_DEFAULT_LONG_TRIGGER_WINDOW / DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS);
+  bounce(INPUT_BANK_TEST_BIT(INPUT_BANK_TEST_LONG_PIN), 0);
+  hold(0, 10);
+
+  TEST_ASSERT_EQUAL_STRING("T5 T33 R33 R5 T0 T5 R5 M5 L0 R0", trace);
+  TEST_ASSERT_EQUAL_UINT32(10, bank->getStats().events);
+}
+
+void test_benchmark() {
+  static const uint8_t inputCounts[] = { 1, 8, 32 };
+  uint32_t seed = 1;
+
+  for (uint8_t i = 0; i < sizeof(inputCounts); i++) {
+    char message[INPUT_BANK_TEST_MESSAGE_SIZE];
+
+    delete bank;
+    bank = new DigitalInputBank();
+    bank->setClock(virtualClock);
+
+    for (uint8_t pin = 0; pin < inputCounts[i]; pin++) {
+      addInput(pin);
+      bank->setLongTrigger(pin);
+      bank->setMultiTrigger(pin);
+    }
+
+    for (int update = 0; update < INPUT_BANK_TEST_BENCHMARK_UPDATES; update++) {
+      // Every pin toggles every 8 ticks and bounces on the first 2 ticks after each edge, as in main.cpp
+      uint64_t levels = ((update >> 3) & 1) ? UINT32_MAX : 0;
+
+      if ((update & 7) < 2) {
+        seed = seed * 1664525 + 1013904223;
+        levels ^= seed;
+      }
+
+      virtualClock.advance(DIGITAL_INPUT_BANK_DEFAULT_TICK_MILLIS);
+      bank->update(levels);
+    }
+
+    DigitalInputBankStats stats = bank->getStats();
+    uint32_t averageTickNanos = (uint32_t) (stats.totalTickMicros * 1000 / stats.ticks);
+
+    snprintf(message, sizeof(message), "Bank of %d inputs: tick avg %u ns max %u us, %u ns per input, %u events",
+      inputCounts[i],
+      averageTickNanos,
+      stats.maxTickMicros,
+      averageTickNanos / inputCounts[i],
+      stats.events);
+    TEST_MESSAGE(message);
+
+    // The bounce never lasts the four ticks, so every pin changes exactly once per 8 ticks after the first
+    TEST_ASSERT_EQUAL_UINT32(INPUT_BANK_TEST_BENCHMARK_UPDATES, stats.ticks);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32((uint32_t) inputCounts[i] * (INPUT_BANK_TEST_BENCHMARK_UPDATES / 8 - 1), stats.events);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_four_ticks_make_a_transition);
+  RUN_TEST(test_held_through_begin_does_not_trigger);
+  RUN_TEST(test_events_across_pins);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+// Splits the NEOPIXEL_LED_COUNT pixels over one or more pins the way the NeoPixel constructors do and checks the
+// segments, the frame time of strips transmitted in parallel and the items each channel is handed by show()
+
+#include <unity.h>
+
+#include "NeoPixel.h"
+
+#define NEOPIXEL_OUTPUT_TEST_ITEMS_PER_PIXEL (NEOPIXEL_OUTPUT_BYTES_PER_PIXEL * NEOPIXEL_OUTPUT_ITEMS_PER_BYTE)
+#define NEOPIXEL_OUTPUT_TEST_MAX_PINS (NEOPIXEL_OUTPUT_MAX_STRIPS + 2)
+
+static const uint8_t PINS[NEOPIXEL_OUTPUT_TEST_MAX_PINS] = { 32, 33, 25, 26, 27, 14, 12, 13, 15, 2 };
+
+static uint32_t getFrameMicros(uint16_t count) {
+  return ((uint32_t) count * NEOPIXEL_OUTPUT_TEST_ITEMS_PER_PIXEL * NEOPIXEL_OUTPUT_BIT_NANOS) / 1000 + NEOPIXEL_OUTPUT_RESET_MICROS;
+}
+
+// Every segment follows the previous one, all of them the same size but the last, which takes the remainder
+static void assertSegments(NeoPixelOutput& output, uint8_t stripCount) {
+  uint16_t segmentCount = NEOPIXEL_LED_COUNT / stripCount;
+  uint16_t first = 0;
+
+  TEST_ASSERT_EQUAL_UINT8(stripCount, output.getStripCount());
+  TEST_ASSERT_EQUAL_UINT16(NEOPIXEL_LED_COUNT, output.getPixelCount());
+
+  for (uint8_t i = 0; i < stripCount; i++) {
+    const NeoPixelSegment* segment = output.getSegment(i);
+    uint16_t count = (i == stripCount - 1) ? NEOPIXEL_LED_COUNT - first : segmentCount;
+
+    TEST_ASSERT_NOT_NULL(segment);
+    TEST_ASSERT_EQUAL_UINT8(PINS[i], segment->pin);
+    TEST_ASSERT_EQUAL_UINT16(first, segment->first);
+    TEST_ASSERT_EQUAL_UINT16(count, segment->count);
+
+    first += count;
+  }
+
+  TEST_ASSERT_NULL(output.getSegment(stripCount));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_single_pin_takes_every_pixel() {
+  NeoPixel neoPixel = NeoPixel(PINS, 1);
+
+  assertSegments(neoPixel.getOutput(), 1);
+  TEST_ASSERT_EQUAL_UINT32(getFrameMicros(NEOPIXEL_LED_COUNT), neoPixel.getOutput().getTransmitMicros());
+}
+
+void test_last_pin_takes_the_remainder() {
+  NeoPixel neoPixel = NeoPixel(PINS, 3);
+
+  assertSegments(neoPixel.getOutput(), 3);
+
+  // 32 over three pins is 10, 10 and 12, the frame takes as long as the 12 and not as long as all of them
+  const NeoPixelSegment* last = neoPixel.getOutput().getSegment(2);
+
+  TEST_ASSERT_EQUAL_UINT16(NEOPIXEL_LED_COUNT / 3 + NEOPIXEL_LED_COUNT % 3, last->count);
+  TEST_ASSERT_EQUAL_UINT32(getFrameMicros(last->count), neoPixel.getOutput().getTransmitMicros());
+  TEST_ASSERT_LESS_THAN_UINT32(getFrameMicros(NEOPIXEL_LED_COUNT), neoPixel.getOutput().getTransmitMicros());
+}
+
+void test_no_pins_means_no_strips() {
+  NeoPixel neoPixel = NeoPixel(PINS, 0);
+
+  TEST_ASSERT_EQUAL_UINT8(0, neoPixel.getOutput().getStripCount());
+  TEST_ASSERT_EQUAL_UINT16(0, neoPixel.getOutput().getPixelCount());
+  TEST_ASSERT_NULL(neoPixel.getOutput().getSegment(0));
+}
+
+void test_extra_pins_are_dropped() {
+  NeoPixel neoPixel = NeoPixel(PINS, NEOPIXEL_OUTPUT_TEST_MAX_PINS);
+
+  // Only as many strips as there are RMT channels, sharing all of the pixels between them
+  assertSegments(neoPixel.getOutput(), NEOPIXEL_OUTPUT_MAX_STRIPS);
+}
+
+void test_transmit_time_is_the_longest_strip() {
+  NeoPixelOutput output = NeoPixelOutput();
+
+  TEST_ASSERT_TRUE(output.addStrip(PINS[0], 100));
+  TEST_ASSERT_TRUE(output.addStrip(PINS[1], 400));
+  TEST_ASSERT_TRUE(output.addStrip(PINS[2], 12));
+
+  TEST_ASSERT_EQUAL_UINT32(getFrameMicros(400), output.getTransmitMicros());
+}
+
+void test_show_writes_each_segment_to_its_channel() {
+  static uint8_t pixels[NEOPIXEL_LED_COUNT * NEOPIXEL_OUTPUT_BYTES_PER_PIXEL];
+  NeoPixelOutput output = NeoPixelOutput();
+
+  output.addStrip(PINS[0], 10);
+  output.addStrip(PINS[1], 10);
+  output.addStrip(PINS[2], NEOPIXEL_LED_COUNT - 20);
+  output.begin();
+
+  uint32_t writes = Host::rmtWrites;
+
+  memset(Host::rmtItemCounts, 0, sizeof(Host::rmtItemCounts));
+  output.show(pixels);
+
+  TEST_ASSERT_EQUAL_UINT32(3, Host::rmtWrites - writes);
+  TEST_ASSERT_EQUAL_INT(10 * NEOPIXEL_OUTPUT_TEST_ITEMS_PER_PIXEL, Host::rmtItemCounts[RMT_CHANNEL_0]);
+  TEST_ASSERT_EQUAL_INT(10 * NEOPIXEL_OUTPUT_TEST_ITEMS_PER_PIXEL, Host::rmtItemCounts[RMT_CHANNEL_1]);
+  TEST_ASSERT_EQUAL_INT((NEOPIXEL_LED_COUNT - 20) * NEOPIXEL_OUTPUT_TEST_ITEMS_PER_PIXEL, Host::rmtItemCounts[RMT_CHANNEL_2]);
+  TEST_ASSERT_EQUAL_INT(0, Host::rmtItemCounts[RMT_CHANNEL_3]);
+
+  output.end();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_pin_takes_every_pixel);
+  RUN_TEST(test_last_pin_takes_the_remainder);
+  RUN_TEST(test_no_pins_means_no_strips);
+  RUN_TEST(test_extra_pins_are_dropped);
+  RUN_TEST(test_transmit_time_is_the_longest_strip);
+  RUN_TEST(test_show_writes_each_segment_to_its_channel);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+// Steps a NeoPixel's playlist on a VirtualClock and reboots it against the Preferences shim, to check entry switches,
+// the fades between entries and that a playlist is only taken, stored or loaded back when every entry is valid
+
+#include <unity.h>
+
+#include "Clock.h"
+#include "NeoPixel.h"
+
+#define PLAYLIST_TEST_FADE_TOLERANCE 8
+#define PLAYLIST_TEST_PIN 32
+
+static const NeoPixelPlaylistEntry PLAYLIST[] = {
+  { NeoPixelMode::Fire, 0, 0, 0, 0, NeoPixelTransition::Cut, 10 },
+  { NeoPixelMode::Plasma, 0, 0, 255, 200, NeoPixelTransition::Cut, 5 }
+};
+
+static NeoPixel neoPixel = NeoPixel(PLAYLIST_TEST_PIN);
+static VirtualClock virtualClock = VirtualClock();
+static uint8_t lastPixel = 0;
+
+static void onFrame(const uint8_t* pixels, uint16_t count) {
+  lastPixel = pixels[0];
+}
+
+static void reboot() {
+  neoPixel.end();
+  neoPixel.begin();
+}
+
+// What the mode task would render after the clock moved on. The strip applies a brightness change to the pixels it
+// already holds, so a fade shows in full from the second frame at the same time
+static void runFor(uint32_t durationMillis) {
+  virtualClock.advance(durationMillis);
+  neoPixel.update();
+  neoPixel.update();
+}
+
+static size_t getStoredPlaylistLength() {
+  Preferences preferences;
+
+  preferences.begin("emilys_neopixel", true);
+  size_t length = preferences.getBytesLength("playlist");
+  preferences.end();
+
+  return length;
+}
+
+static void storePlaylist(const NeoPixelPlaylistEntry entries[], uint8_t count) {
+  Preferences preferences;
+
+  preferences.begin("emilys_neopixel", false);
+  preferences.putBytes("playlist", entries, count * sizeof(NeoPixelPlaylistEntry));
+  preferences.end();
+}
+
+void setUp() {
+  neoPixel.stopPlaylist();
+  neoPixel.setPlaylist(NULL, 0);
+  Host::clearPreferences();
+  reboot();
+}
+
+void tearDown() {
+}
+
+void test_entries_switch_after_their_duration() {
+  TEST_ASSERT_TRUE(neoPixel.setPlaylist(PLAYLIST, 2));
+
+  neoPixel.startPlaylist();
+  runFor(0);
+
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Fire, (uint8_t) neoPixel.getMode());
+
+  runFor(PLAYLIST[0].duration * 1000 - 1);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Fire, (uint8_t) neoPixel.getMode());
+
+  // The second entry brings its own color and brightness along
+  runFor(1);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Plasma, (uint8_t) neoPixel.getMode());
+  TEST_ASSERT_EQUAL_HEX32(0x0000FF, neoPixel.getColor());
+  TEST_ASSERT_EQUAL_UINT8(200, neoPixel.getBrightness());
+
+  runFor(PLAYLIST[1].duration * 1000);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Fire, (uint8_t) neoPixel.getMode());
+}
+
+void test_fades_between_entries() {
+  static const NeoPixelPlaylistEntry fadePlaylist[] = {
+    { NeoPixelMode::Solid, 255, 255, 255, 255, NeoPixelTransition::Fade, 10 },
+    { NeoPixelMode::Solid, 255, 255, 255, 255, NeoPixelTransition::Fade, 10 }
+  };
+
+  TEST_ASSERT_TRUE(neoPixel.setPlaylist(fadePlaylist, 2));
+
+  neoPixel.startPlaylist();
+  runFor(0);
+  TEST_ASSERT_UINT8_WITHIN(PLAYLIST_TEST_FADE_TOLERANCE, 0, lastPixel);
+
+  // Halfway into the fade in, then fully up until the next entry's fade in is due
+  runFor(NEOPIXEL_PLAYLIST_FADE_MILLIS / 2);
+  TEST_ASSERT_UINT8_WITHIN(PLAYLIST_TEST_FADE_TOLERANCE, 127, lastPixel);
+
+  runFor(5000 - NEOPIXEL_PLAYLIST_FADE_MILLIS / 2);
+  TEST_ASSERT_UINT8_WITHIN(PLAYLIST_TEST_FADE_TOLERANCE, 255, lastPixel);
+
+  runFor(4000);
+  TEST_ASSERT_UINT8_WITHIN(PLAYLIST_TEST_FADE_TOLERANCE, 127, lastPixel);
+
+  // The next entry starts dark and fades in again
+  runFor(1000);
+  TEST_ASSERT_UINT8_WITHIN(PLAYLIST_TEST_FADE_TOLERANCE, 0, lastPixel);
+}
+
+void test_invalid_playlists_are_refused() {
+  static const NeoPixelPlaylistEntry zeroDuration[] = { { NeoPixelMode::Fire, 0, 0, 0, 0, NeoPixelTransition::Cut, 0 } };
+  static const NeoPixelPlaylistEntry unknownMode[] = { { (NeoPixelMode) (NEOPIXEL_MAX_MODE + 1), 0, 0, 0, 0, NeoPixelTransition::Cut, 10 } };
+  static const NeoPixelPlaylistEntry unknownTransition[] = { { NeoPixelMode::Fire, 0, 0, 0, 0, (NeoPixelTransition) 2, 10 } };
+
+  TEST_ASSERT_TRUE(neoPixel.setPlaylist(PLAYLIST, 2));
+
+  TEST_ASSERT_FALSE(neoPixel.setPlaylist(zeroDuration, 1));
+  TEST_ASSERT_FALSE(neoPixel.setPlaylist(unknownMode, 1));
+  TEST_ASSERT_FALSE(neoPixel.setPlaylist(unknownTransition, 1));
+  TEST_ASSERT_FALSE(neoPixel.setPlaylist(NULL, 1));
+
+  // The playlist from before is still the one in use and in storage
+  TEST_ASSERT_EQUAL_UINT32(sizeof(PLAYLIST), getStoredPlaylistLength());
+
+  neoPixel.startPlaylist();
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Fire, (uint8_t) neoPixel.getMode());
+}
+
+void test_invalid_stored_playlists_load_the_default() {
+  static const NeoPixelPlaylistEntry storedPlaylists[][1] = {
+    { { NeoPixelMode::Fire, 0, 0, 0, 0, NeoPixelTransition::Cut, 0 } },
+    { { (NeoPixelMode) (NEOPIXEL_MAX_MODE + 1), 0, 0, 0, 0, NeoPixelTransition::Cut, 10 } },
+    { { NeoPixelMode::Fire, 0, 0, 0, 0, (NeoPixelTransition) 2, 10 } }
+  };
+
+  for (const NeoPixelPlaylistEntry* storedPlaylist : storedPlaylists) {
+    neoPixel.stopPlaylist();
+    storePlaylist(storedPlaylist, 1);
+    reboot();
+
+    // The default playlist starts on Solid
+    neoPixel.startPlaylist();
+    TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Solid, (uint8_t) neoPixel.getMode());
+  }
+}
+
+void test_stored_playlist_survives_a_reboot_until_removed() {
+  TEST_ASSERT_TRUE(neoPixel.setPlaylist(PLAYLIST, 2));
+  reboot();
+
+  neoPixel.startPlaylist();
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Fire, (uint8_t) neoPixel.getMode());
+
+  neoPixel.stopPlaylist();
+  TEST_ASSERT_TRUE(neoPixel.setPlaylist(NULL, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, getStoredPlaylistLength());
+
+  reboot();
+
+  neoPixel.startPlaylist();
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Solid, (uint8_t) neoPixel.getMode());
+}
+
+int main() {
+  neoPixel.setClock(virtualClock);
+  neoPixel.onFrame(onFrame);
+  neoPixel.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_entries_switch_after_their_duration);
+  RUN_TEST(test_fades_between_entries);
+  RUN_TEST(test_invalid_playlists_are_refused);
+  RUN_TEST(test_invalid_stored_playlists_load_the_default);
+  RUN_TEST(test_stored_playlist_survives_a_reboot_until_removed);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+// Feeds command lines to a SerialConsole and renders the frames the mode task would, to check which commands the
+// latency statistics time and which they leave alone because nothing is rendered for them, how lines are parsed and
+// that replies wait for room in the stream instead of blocking
+
+#include <unity.h>
+
+#include "Clock.h"
+#include "NeoPixel.h"
+#include "SerialConsole.h"
+
+#define SERIAL_CONSOLE_TEST_BUFFER_SIZE 512
+#define SERIAL_CONSOLE_TEST_PIN 32
+
+class BufferStream : public Stream {
+  public:
+    char input[SERIAL_CONSOLE_TEST_BUFFER_SIZE];
+    size_t inputLength = 0;
+    size_t inputPosition = 0;
+    char output[SERIAL_CONSOLE_TEST_BUFFER_SIZE];
+    size_t outputLength = 0;
+    // What the TX FIFO has room for
+    size_t writable = SERIAL_CONSOLE_TEST_BUFFER_SIZE;
+
+    int available() override {
+      return (int) (inputLength - inputPosition);
+    }
+
+    int availableForWrite() override {
+      return (int) min(writable, sizeof(output) - 1 - outputLength);
+    }
+
+    void clear() {
+      inputLength = inputPosition = outputLength = 0;
+      output[0] = '\0';
+      writable = SERIAL_CONSOLE_TEST_BUFFER_SIZE;
+    }
+
+    int read() override {
+      return inputPosition < inputLength ? input[inputPosition++] : -1;
+    }
+
+    void send(const char* line) {
+      size_t length = min(strlen(line), sizeof(input) - inputLength);
+
+      memcpy(input + inputLength, line, length);
+      inputLength += length;
+    }
+
+    size_t write(uint8_t c) override {
+      if (outputLength >= sizeof(output) - 1) {
+        return 0;
+      }
+
+      output[outputLength++] = c;
+      output[outputLength] = '\0';
+      return 1;
+    }
+};
+
+static BufferStream stream;
+static VirtualClock virtualClock = VirtualClock();
+static NeoPixel neoPixel = NeoPixel(SERIAL_CONSOLE_TEST_PIN);
+static SerialConsole serialConsole = SerialConsole(stream, neoPixel);
+
+// A command goes in, the mode task renders if it was woken, then the next poll picks up the frame time
+static void run(const char* line) {
+  stream.send(line);
+  serialConsole.poll();
+
+  if (Host::takeNotification(Host::findTask("neopixel_model_task"))) {
+    neoPixel.update();
+  }
+
+  serialConsole.poll();
+}
+
+void setUp() {
+  stream.clear();
+  neoPixel.stopPlaylist();
+  neoPixel.setMode(NeoPixelMode::Solid);
+  neoPixel.setBrightness(64);
+  neoPixel.setColor(255, 0, 0);
+  neoPixel.update();
+  Host::takeNotification(Host::findTask("neopixel_model_task"));
+  serialConsole.resetStats();
+}
+
+void tearDown() {
+}
+
+void test_changes_are_timed() {
+  run("brightness 128\n");
+  run("color 0 255 0\n");
+  run("palette blue\n");
+  run("mode 2\n");
+
+  SerialConsoleStats stats = serialConsole.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(4, stats.commands);
+  TEST_ASSERT_EQUAL_UINT32(4, stats.latencySamples);
+}
+
+void test_unchanged_values_are_not_timed() {
+  run("brightness 64\n");
+  run("color 255 0 0\n");
+  run("palette red\n");
+  run("mode 1\n");
+  run("stats\n");
+
+  TEST_ASSERT_EQUAL_UINT32(0, serialConsole.getStats().latencySamples);
+
+  // A frame from anything else afterwards must not be counted against them either
+  neoPixel.update();
+  serialConsole.poll();
+
+  SerialConsoleStats stats = serialConsole.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(5, stats.commands);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.errors);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.latencySamples);
+}
+
+void test_mode_stopping_the_playlist_is_timed() {
+  neoPixel.startPlaylist();
+  neoPixel.update();
+  Host::takeNotification(Host::findTask("neopixel_model_task"));
+
+  char line[32];
+
+  snprintf(line, sizeof(line), "mode %d\n", (int) neoPixel.getMode());
+  run(line);
+
+  TEST_ASSERT_FALSE(neoPixel.isPlaylistActive());
+  TEST_ASSERT_EQUAL_UINT32(1, serialConsole.getStats().latencySamples);
+}
+
+void test_errors_are_not_timed() {
+  run("brightness 300\n");
+  run("palette nope\n");
+
+  SerialConsoleStats stats = serialConsole.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(2, stats.errors);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.latencySamples);
+}
+
+void test_line_split_across_polls() {
+  stream.send("bright");
+  serialConsole.poll();
+
+  TEST_ASSERT_EQUAL_UINT32(0, serialConsole.getStats().commands);
+  TEST_ASSERT_EQUAL_STRING("", stream.output);
+
+  run("ness 128\n");
+
+  TEST_ASSERT_EQUAL_UINT32(1, serialConsole.getStats().commands);
+  TEST_ASSERT_EQUAL_UINT8(128, neoPixel.getBrightness());
+  TEST_ASSERT_EQUAL_STRING("ok\n", stream.output);
+}
+
+void test_overlong_line() {
+  char line[SERIAL_CONSOLE_LINE_SIZE * 2];
+
+  memset(line, 'x', sizeof(line) - 2);
+  line[sizeof(line) - 2] = '\n';
+  line[sizeof(line) - 1] = '\0';
+  run(line);
+
+  // The rest of the overlong line is thrown away with it, the next line is read as usual
+  run("brightness 32\n");
+
+  SerialConsoleStats stats = serialConsole.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(1, stats.overflows);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.errors);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.commands);
+  TEST_ASSERT_EQUAL_UINT8(32, neoPixel.getBrightness());
+  TEST_ASSERT_EQUAL_STRING("error: line too long\nok\n", stream.output);
+}
+
+void test_bad_numbers() {
+  static const char* const LINES[] = {
+    "brightness 256\n",
+    "brightness -1\n",
+    "brightness 12x\n",
+    "brightness\n",
+    "color 1 2\n",
+    "color 1 2 300\n",
+    "mode 99\n",
+    "mode one\n"
+  };
+
+  for (const char* line : LINES) {
+    run(line);
+  }
+
+  SerialConsoleStats stats = serialConsole.getStats();
+
+  TEST_ASSERT_EQUAL_UINT32(sizeof(LINES) / sizeof(LINES[0]), stats.errors);
+  TEST_ASSERT_EQUAL_UINT8(64, neoPixel.getBrightness());
+  TEST_ASSERT_EQUAL_HEX32(0xFF0000, neoPixel.getColor());
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Solid, (uint8_t) neoPixel.getMode());
+}
+
+void test_palette_lookup() {
+  run("palette warm\n");
+
+  TEST_ASSERT_EQUAL_HEX32(0xFF9329, neoPixel.getColor());
+  TEST_ASSERT_EQUAL_STRING("ok\n", stream.output);
+}
+
+void test_full_stream_does_not_block() {
+  stream.writable = 0;
+  run("stats\n");
+  run("stats\n");
+
+  // Both ran without a byte written, the replies are kept until there is room
+  TEST_ASSERT_EQUAL_UINT32(2, serialConsole.getStats().commands);
+  TEST_ASSERT_EQUAL_STRING("", stream.output);
+
+  // With the reply buffer this full the next line stays in the stream
+  run("brightness 100\n");
+
+  TEST_ASSERT_EQUAL_UINT32(2, serialConsole.getStats().commands);
+  TEST_ASSERT_EQUAL_UINT8(64, neoPixel.getBrightness());
+
+  // A few bytes at a time drains it and the waiting line runs once there is room for its reply
+  stream.writable = 16;
+
+  while (serialConsole.getStats().commands < 3) {
+    serialConsole.poll();
+  }
+
+  stream.writable = SERIAL_CONSOLE_TEST_BUFFER_SIZE;
+  serialConsole.poll();
+
+  TEST_ASSERT_EQUAL_UINT8(100, neoPixel.getBrightness());
+  TEST_ASSERT_EQUAL_STRING_LEN("frames ", stream.output, 7);
+  TEST_ASSERT_EQUAL_STRING("ok\n", stream.output + stream.outputLength - 3);
+}
+
+int main() {
+  neoPixel.setClock(virtualClock);
+  neoPixel.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_changes_are_timed);
+  RUN_TEST(test_unchanged_values_are_not_timed);
+  RUN_TEST(test_mode_stopping_the_playlist_is_timed);
+  RUN_TEST(test_errors_are_not_timed);
+  RUN_TEST(test_line_split_across_polls);
+  RUN_TEST(test_overlong_line);
+  RUN_TEST(test_bad_numbers);
+  RUN_TEST(test_palette_lookup);
+  RUN_TEST(test_full_stream_does_not_block);
+  return UNITY_END();
+}
\ No newline at end of file
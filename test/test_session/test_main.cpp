@@ -0,0 +1,748 @@
+// A day with the lamp in virtual time. The input and mode task loops are stepped from one VirtualClock that millis()
+// follows too, and driven by button presses with contact bounce and knob sweeps with ADC noise. The clock starts two
+// hours before millis() wraps, and the sleep timer puts the lamp into deep sleep for the mode button to wake it again
+
+#include <chrono>
+#include <new>
+#include <unity.h>
+
+#include "AnalogFrontEnd.h"
+#include "AnalogInput.h"
+#include "ButtonGestures.h"
+#include "Clock.h"
+#include "DigitalInput.h"
+#include "GestureRecognizer.h"
+#include "NeoPixel.h"
+#include "SteppedDigitalInput.h"
+
+// The same wiring as main.cpp, the gestures and what they do come from ButtonGestures like there
+#define BLUE_PIN 36
+#define BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW 1000
+#define BRIGHTNESS_BUTTON_PIN 25
+#define GREEN_PIN 39
+#define LOOP_INTERVAL 10
+#define MODE_BUTTON_LONG_TRIGGER_WINDOW 1000
+#define MODE_BUTTON_PIN 26
+#define NEOPIXEL_CONTROL_PIN 32
+#define RED_PIN 34
+
+#define SESSION_ANALOG_INTERVAL 10
+#define SESSION_ANALOG_NOISE 6
+#define SESSION_BOUNCE_EDGES 3
+#define SESSION_DAY_MILLIS (24 * 3600000UL)
+#define SESSION_HOUR_MILLIS 3600000UL
+#define SESSION_KNOB_COUNT 3
+#define SESSION_MAX_EDGES 64
+#define SESSION_MESSAGE_SIZE 160
+#define SESSION_SLEEP_HOUR 16
+#define SESSION_START_MILLIS (UINT32_MAX - 2 * SESSION_HOUR_MILLIS)
+#define SESSION_VISIT_MILLIS (20 * 60000UL)
+#define SESSION_WAKE_HOUR 23
+
+// The input task loops, run by the session instead of FreeRTOS
+class SteppedAnalogInput : public AnalogInput {
+  public:
+    using AnalogInput::AnalogInput;
+
+    void update() {
+      _handleInput();
+    }
+};
+
+// A task blocked in xTaskNotifyWait, without a timeout only a notification wakes it
+struct SessionTask {
+  bool timed;
+  uint32_t wakeTime;
+};
+
+struct SessionEdge {
+  uint32_t time;
+  uint8_t pin;
+  uint8_t level;
+};
+
+struct SessionSweep {
+  uint32_t startTime;
+  uint32_t duration;
+  uint16_t from;
+  uint16_t to;
+};
+
+// Kept across reboots, each lamp's own counters are added in before it goes
+struct SessionStats {
+  uint32_t analogEvents;
+  uint32_t boots;
+  uint32_t brightnessEvents[4];
+  uint32_t brightnessPresses;
+  uint32_t deepSleepTime;
+  DigitalInputStats digitalInput;
+  NeoPixelFrameStats frames;
+  GestureRecognizerStats gestures;
+  uint32_t maxRenderMicros;
+  uint32_t modeEvents[4];
+  uint32_t modePresses;
+  uint64_t samples;
+  NeoPixelMode sleepMode;
+  bool sleepPlaylistActive;
+};
+
+class Lamp {
+  public:
+    Lamp();
+
+    AnalogFrontEnd analogFrontEnd;
+    SteppedDigitalInput brightnessButton;
+    GestureRecognizer brightnessGestures;
+    SteppedAnalogInput knobs[SESSION_KNOB_COUNT];
+    SteppedDigitalInput modeButton;
+    GestureRecognizer modeGestures;
+    NeoPixel neoPixel;
+    ButtonGestures buttonGestures;
+
+    uint32_t nextAnalogTime;
+    uint32_t nextLoopTime;
+    TaskHandle_t neoPixelTask;
+    SessionTask neoPixelWait;
+
+    void onBrightnessInput(DigitalInputEvent event);
+    void onKnob(uint16_t value);
+    void onModeInput(DigitalInputEvent event);
+};
+
+static const uint8_t KNOB_PINS[SESSION_KNOB_COUNT] = { RED_PIN, GREEN_PIN, BLUE_PIN };
+
+static VirtualClock sessionClock = VirtualClock(SESSION_START_MILLIS);
+
+alignas(Lamp) static uint8_t lampBuffer[sizeof(Lamp)];
+static Lamp* lamp = NULL;
+static bool asleep = false;
+static uint32_t deepSleeps = 0;
+
+static SessionEdge edges[SESSION_MAX_EDGES];
+static uint8_t edgeCount = 0;
+static SessionSweep sweeps[SESSION_KNOB_COUNT];
+static SessionStats stats = {};
+
+// Every C++ allocation in the whole run, a lambda or std::function handler that outgrows its inline storage ends up here
+static uint32_t allocations = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+
+  void* pointer = malloc(max(size, (size_t) 1));
+
+  if (pointer == NULL) {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  free(pointer);
+}
+
+static uint32_t getSessionMillis() {
+  return sessionClock.getMillis();
+}
+
+static bool isDue(uint32_t time) {
+  return (int32_t) (time - sessionClock.getMillis()) <= 0;
+}
+
+static void schedule(SessionTask& task, TickType_t ticksToWait) {
+  task.timed = ticksToWait != portMAX_DELAY;
+  task.wakeTime = sessionClock.getMillis() + ticksToWait;
+}
+
+// The same wait as the mode task, one tick at the least and one more so it lands on or after the step
+static void scheduleNeoPixel() {
+  uint32_t waitMillis = lamp->neoPixel.getWaitMillis();
+
+  schedule(lamp->neoPixelWait, pdMS_TO_TICKS(max(waitMillis, (uint32_t) 1)) + 1);
+}
+
+Lamp::Lamp():
+  brightnessButton(BRIGHTNESS_BUTTON_PIN),
+  brightnessGestures(ButtonGestures::BRIGHTNESS_GESTURES, BRIGHTNESS_GESTURE_COUNT),
+  knobs { { RED_PIN }, { GREEN_PIN }, { BLUE_PIN } },
+  modeButton(MODE_BUTTON_PIN),
+  modeGestures(ButtonGestures::MODE_GESTURES, MODE_GESTURE_COUNT),
+  neoPixel(NEOPIXEL_CONTROL_PIN),
+  buttonGestures(neoPixel) {
+
+  brightnessGestures.setClock(sessionClock);
+  brightnessGestures.begin();
+  brightnessGestures.onEvent(GestureEventHandler::bind<ButtonGestures, &ButtonGestures::handleBrightnessGesture>(&buttonGestures));
+  brightnessGestures.setInput(brightnessButton);
+
+  brightnessButton.setClock(sessionClock);
+  brightnessButton.setDebounce();
+  brightnessButton.setLongTrigger(BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW);
+  brightnessButton.begin();
+  brightnessButton.onEvent(DigitalInputEventHandler::bind<Lamp, &Lamp::onBrightnessInput>(this));
+
+  for (uint8_t i = 0; i < SESSION_KNOB_COUNT; i++) {
+    knobs[i].setClock(sessionClock);
+    knobs[i].setFrontEnd(analogFrontEnd);
+    knobs[i].begin();
+    knobs[i].onEvent(AnalogInputEventHandler::bind<Lamp, &Lamp::onKnob>(this));
+  }
+
+  modeGestures.setClock(sessionClock);
+  modeGestures.begin();
+  modeGestures.onEvent(GestureEventHandler::bind<ButtonGestures, &ButtonGestures::handleModeGesture>(&buttonGestures));
+  modeGestures.setInput(modeButton);
+
+  modeButton.setClock(sessionClock);
+  modeButton.setDebounce();
+  modeButton.setLongTrigger(MODE_BUTTON_LONG_TRIGGER_WINDOW);
+  modeButton.begin();
+  modeButton.onEvent(DigitalInputEventHandler::bind<Lamp, &Lamp::onModeInput>(this));
+
+  neoPixel.setClock(sessionClock);
+  neoPixel.begin();
+  neoPixel.setLinearColor(knobs[0].getValue(), knobs[1].getValue(), knobs[2].getValue());
+
+  neoPixelTask = Host::findTask("neopixel_model_task");
+  nextAnalogTime = sessionClock.getMillis() + SESSION_ANALOG_INTERVAL;
+  nextLoopTime = sessionClock.getMillis() + LOOP_INTERVAL;
+}
+
+void Lamp::onBrightnessInput(DigitalInputEvent event) {
+  stats.brightnessEvents[(uint8_t) event]++;
+  brightnessGestures.handleEvent(event);
+}
+
+void Lamp::onKnob(uint16_t value) {
+  stats.analogEvents++;
+  neoPixel.setLinearColor(knobs[0].getValue(), knobs[1].getValue(), knobs[2].getValue());
+}
+
+void Lamp::onModeInput(DigitalInputEvent event) {
+  stats.modeEvents[(uint8_t) event]++;
+  modeGestures.handleEvent(event);
+}
+
+static void addEdge(uint32_t delayMillis, uint8_t pin, uint8_t level) {
+  uint32_t time = sessionClock.getMillis() + delayMillis;
+  uint8_t i = edgeCount;
+
+  TEST_ASSERT_TRUE_MESSAGE(edgeCount < SESSION_MAX_EDGES, "Too many pending edges");
+
+  // Kept in time order, ties in the order they were added
+  while (i > 0 && (int32_t) (edges[i - 1].time - time) > 0) {
+    edges[i] = edges[i - 1];
+    i--;
+  }
+
+  edges[i] = { time, pin, level };
+  edgeCount++;
+}
+
+static void collectStats() {
+  DigitalInputStats inputs[] = { lamp->brightnessButton.getStats(), lamp->modeButton.getStats() };
+  GestureRecognizerStats gestures[] = { lamp->brightnessGestures.getStats(), lamp->modeGestures.getStats() };
+  NeoPixelFrameStats frames = lamp->neoPixel.getFrameStats();
+
+  for (const DigitalInputStats& input : inputs) {
+    stats.digitalInput.droppedEdges += input.droppedEdges;
+    stats.digitalInput.edges += input.edges;
+    stats.digitalInput.events += input.events;
+    stats.digitalInput.latencySamples += input.latencySamples;
+    stats.digitalInput.maxLatency = max(stats.digitalInput.maxLatency, input.maxLatency);
+    stats.digitalInput.totalLatency += input.totalLatency;
+    stats.digitalInput.wakeups += input.wakeups;
+  }
+
+  for (const GestureRecognizerStats& gesture : gestures) {
+    stats.gestures.cancellations += gesture.cancellations;
+    stats.gestures.confirmations += gesture.confirmations;
+    stats.gestures.maxDecisionMillis = max(stats.gestures.maxDecisionMillis, gesture.maxDecisionMillis);
+    stats.gestures.speculations += gesture.speculations;
+    stats.gestures.totalDecisionMillis += gesture.totalDecisionMillis;
+  }
+
+  stats.frames.frames += frames.frames;
+  stats.frames.steps += frames.steps;
+  stats.frames.totalRenderMicros += frames.totalRenderMicros;
+  stats.maxRenderMicros = max(stats.maxRenderMicros, frames.maxRenderMicros);
+  stats.samples += lamp->analogFrontEnd.getStats().samples;
+
+  lamp->analogFrontEnd.resetStats();
+  lamp->brightnessButton.resetStats();
+  lamp->brightnessGestures.resetStats();
+  lamp->modeButton.resetStats();
+  lamp->modeGestures.resetStats();
+  lamp->neoPixel.resetFrameStats();
+}
+
+// A cold boot or the EXT0 wake up from the sleep timer's deep sleep, NVS and RTC memory are all that carry over
+static void bootLamp(esp_sleep_wakeup_cause_t wakeupCause) {
+  if (lamp != NULL) {
+    collectStats();
+    lamp->~Lamp();
+  }
+
+  Host::wakeupCause = wakeupCause;
+  lamp = new (lampBuffer) Lamp();
+  Host::wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+  lamp->brightnessButton.wait();
+  lamp->modeButton.wait();
+  scheduleNeoPixel();
+
+  asleep = false;
+  stats.boots++;
+}
+
+static void glitch(uint8_t pin, uint32_t delayMillis, uint32_t lengthMillis) {
+  addEdge(delayMillis, pin, LOW);
+  addEdge(delayMillis + lengthMillis, pin, HIGH);
+}
+
+static uint8_t offsetMode(NeoPixelMode mode, int8_t offset) {
+  return (uint8_t) (((int16_t) mode + offset + NEOPIXEL_MAX_MODE + 1) % (NEOPIXEL_MAX_MODE + 1));
+}
+
+// Both contacts bounce for a couple of milliseconds, pressed pulls the pin low
+static void press(uint8_t pin, uint32_t delayMillis, uint32_t holdMillis) {
+  for (uint8_t i = 0; i < SESSION_BOUNCE_EDGES; i++) {
+    addEdge(delayMillis + i, pin, (i % 2 == 0) ? LOW : HIGH);
+    addEdge(delayMillis + holdMillis + i, pin, (i % 2 == 0) ? HIGH : LOW);
+  }
+
+  if (pin == MODE_BUTTON_PIN) {
+    stats.modePresses++;
+  } else {
+    stats.brightnessPresses++;
+  }
+}
+
+static bool runNeoPixel() {
+  bool notified = Host::takeNotification(lamp->neoPixelTask);
+
+  if (!notified && !isDue(lamp->neoPixelWait.wakeTime)) {
+    return false;
+  }
+
+  lamp->neoPixel.update();
+
+  // esp_deep_sleep_start() returns on the host, everything stops here until the lamp is woken
+  if (Host::deepSleeps != deepSleeps) {
+    deepSleeps = Host::deepSleeps;
+    stats.deepSleepTime = sessionClock.getMillis();
+    stats.sleepMode = lamp->neoPixel.getMode();
+    stats.sleepPlaylistActive = lamp->neoPixel.isPlaylistActive();
+    asleep = true;
+    return true;
+  }
+
+  scheduleNeoPixel();
+  return true;
+}
+
+static void sweep(uint8_t knob, uint16_t level, uint32_t durationMillis) {
+  SessionSweep& knobSweep = sweeps[knob];
+
+  knobSweep.from = Host::analogLevels[KNOB_PINS[knob]];
+  knobSweep.to = level;
+  knobSweep.startTime = sessionClock.getMillis();
+  knobSweep.duration = max(durationMillis, (uint32_t) 1);
+}
+
+static void updateKnobs() {
+  for (uint8_t i = 0; i < SESSION_KNOB_COUNT; i++) {
+    const SessionSweep& knobSweep = sweeps[i];
+    uint32_t elapsed = min(sessionClock.getMillis() - knobSweep.startTime, knobSweep.duration);
+    int32_t level = knobSweep.from + ((int32_t) knobSweep.to - knobSweep.from) * (int32_t) elapsed / (int32_t) knobSweep.duration;
+
+    Host::setAnalogLevel(KNOB_PINS[i], (uint16_t) level);
+    lamp->knobs[i].update();
+  }
+}
+
+// Everything due now, the tasks again after anything that could have notified them
+static void step() {
+  if (asleep) {
+    edgeCount = 0;
+    return;
+  }
+
+  while (edgeCount > 0 && isDue(edges[0].time)) {
+    Host::setPinLevel(edges[0].pin, edges[0].level);
+    memmove(edges, edges + 1, --edgeCount * sizeof(SessionEdge));
+  }
+
+  for (;;) {
+    bool ran = Host::runTimers();
+
+    ran |= lamp->modeButton.step();
+    ran |= lamp->brightnessButton.step();
+
+    if (asleep) {
+      return;
+    }
+
+    ran |= runNeoPixel();
+
+    if (asleep) {
+      return;
+    }
+
+    if (isDue(lamp->nextAnalogTime)) {
+      lamp->nextAnalogTime += SESSION_ANALOG_INTERVAL;
+      updateKnobs();
+      ran = true;
+    }
+
+    if (isDue(lamp->nextLoopTime)) {
+      lamp->nextLoopTime += LOOP_INTERVAL;
+      lamp->brightnessGestures.poll();
+      lamp->modeGestures.poll();
+      ran = true;
+    }
+
+    if (!ran) {
+      return;
+    }
+  }
+}
+
+static uint32_t untilNext(uint32_t waitMillis, uint32_t time) {
+  return min(waitMillis, time - sessionClock.getMillis());
+}
+
+static void runFor(uint32_t durationMillis) {
+  uint32_t endTime = sessionClock.getMillis() + durationMillis;
+
+  for (;;) {
+    step();
+
+    uint32_t waitMillis = untilNext(UINT32_MAX, endTime);
+
+    if (waitMillis == 0) {
+      return;
+    }
+
+    if (!asleep) {
+      waitMillis = untilNext(waitMillis, lamp->nextAnalogTime);
+      waitMillis = untilNext(waitMillis, lamp->nextLoopTime);
+      waitMillis = untilNext(waitMillis, lamp->neoPixelWait.wakeTime);
+
+      if (edgeCount > 0) {
+        waitMillis = untilNext(waitMillis, edges[0].time);
+      }
+
+      uint32_t timerTime = 0;
+
+      if (Host::getNextTimerTime(timerTime)) {
+        waitMillis = untilNext(waitMillis, timerTime);
+      }
+
+      uint32_t wakeTime = 0;
+
+      if (lamp->brightnessButton.getWakeTime(wakeTime)) {
+        waitMillis = untilNext(waitMillis, wakeTime);
+      }
+
+      if (lamp->modeButton.getWakeTime(wakeTime)) {
+        waitMillis = untilNext(waitMillis, wakeTime);
+      }
+    }
+
+    sessionClock.advance(waitMillis);
+  }
+}
+
+static void report(const char* format, ...) {
+  char message[SESSION_MESSAGE_SIZE];
+  va_list args;
+
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+
+  TEST_MESSAGE(message);
+}
+
+// Presses, a double press, a knob sweep and a glitch, and every third visit a long press to start the playlist
+static void visit(uint16_t visitIndex) {
+  press(MODE_BUTTON_PIN, 0, 120);
+  press(MODE_BUTTON_PIN, 2000, 80);
+  press(MODE_BUTTON_PIN, 2230, 80);
+  press(BRIGHTNESS_BUTTON_PIN, 4000, 100);
+  runFor(6000);
+
+  sweep(visitIndex % SESSION_KNOB_COUNT, (uint16_t) ((visitIndex * 997UL) % 4096), 3000);
+  glitch(BRIGHTNESS_BUTTON_PIN, 6000, DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW / 4);
+
+  if (visitIndex % 3 == 0) {
+    press(MODE_BUTTON_PIN, 8000, 1500);
+  }
+
+  runFor(SESSION_VISIT_MILLIS - 6000);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_glitch_shorter_than_debounce_is_ignored() {
+  SessionStats before = stats;
+
+  glitch(MODE_BUTTON_PIN, 0, DIGITAL_INPUT_DEFAULT_DEBOUNCE_WINDOW - 1);
+  runFor(1000);
+
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::Trigger], stats.modeEvents[(uint8_t) DigitalInputEvent::Trigger]);
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::Release], stats.modeEvents[(uint8_t) DigitalInputEvent::Release]);
+}
+
+void test_bounce_is_one_press() {
+  SessionStats before = stats;
+  NeoPixelMode mode = lamp->neoPixel.getMode();
+
+  press(MODE_BUTTON_PIN, 0, 100);
+  runFor(1000);
+
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::Trigger] + 1, stats.modeEvents[(uint8_t) DigitalInputEvent::Trigger]);
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::Release] + 1, stats.modeEvents[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_EQUAL_UINT8(offsetMode(mode, 1), (uint8_t) lamp->neoPixel.getMode());
+}
+
+void test_long_trigger_window() {
+  SessionStats before = stats;
+
+  // Just short of the window is a short press, past it the long trigger fires while the button is still held
+  press(MODE_BUTTON_PIN, 0, MODE_BUTTON_LONG_TRIGGER_WINDOW - 50);
+  runFor(2000);
+
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger], stats.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger]);
+  TEST_ASSERT_FALSE(lamp->neoPixel.isPlaylistActive());
+
+  press(MODE_BUTTON_PIN, 0, MODE_BUTTON_LONG_TRIGGER_WINDOW + 50);
+  runFor(2000);
+
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger] + 1, stats.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger]);
+  TEST_ASSERT_TRUE(lamp->neoPixel.isPlaylistActive());
+}
+
+void test_gap_window() {
+  NeoPixelMode mode = lamp->neoPixel.getMode();
+
+  // Inside the gap the second press undoes the first and goes back one
+  press(MODE_BUTTON_PIN, 0, 80);
+  press(MODE_BUTTON_PIN, 80 + GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW / 2, 80);
+  runFor(2000);
+
+  TEST_ASSERT_EQUAL_UINT8(offsetMode(mode, -1), (uint8_t) lamp->neoPixel.getMode());
+
+  // Outside it they are two single presses
+  press(MODE_BUTTON_PIN, 0, 80);
+  press(MODE_BUTTON_PIN, 80 + GESTURE_RECOGNIZER_DEFAULT_GAP_WINDOW * 2, 80);
+  runFor(2000);
+
+  TEST_ASSERT_EQUAL_UINT8(offsetMode(mode, 1), (uint8_t) lamp->neoPixel.getMode());
+}
+
+void test_still_knob_raises_nothing() {
+  sweep(0, 3000, 2000);
+  runFor(3000);
+
+  SessionStats before = stats;
+
+  // ADC noise on a knob nobody touches stays inside the noise band
+  runFor(60000);
+
+  TEST_ASSERT_EQUAL_UINT32(before.analogEvents, stats.analogEvents);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, before.analogEvents);
+}
+
+void test_long_press_across_millis_wrap() {
+  SessionStats before = stats;
+
+  // Out of the playlist the last test started so the long press starts it again
+  press(MODE_BUTTON_PIN, 0, 80);
+  runFor(1000);
+
+  // Pressed half a second before millis() wraps, the long trigger fires after it
+  runFor(UINT32_MAX - 499 - sessionClock.getMillis());
+  press(MODE_BUTTON_PIN, 0, MODE_BUTTON_LONG_TRIGGER_WINDOW + 500);
+  runFor(2000);
+
+  TEST_ASSERT_TRUE(sessionClock.getMillis() < SESSION_START_MILLIS);
+  TEST_ASSERT_EQUAL_UINT32(before.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger] + 1, stats.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger]);
+  TEST_ASSERT_TRUE(lamp->neoPixel.isPlaylistActive());
+
+  // The first playlist entry keeps stepping once a second on the other side
+  uint32_t steps = lamp->neoPixel.getFrameStats().steps;
+
+  runFor(10000);
+
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) NeoPixelMode::Solid, (uint8_t) lamp->neoPixel.getMode());
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(steps + 9, lamp->neoPixel.getFrameStats().steps);
+}
+
+void test_sleep_timer_and_wake() {
+  press(BRIGHTNESS_BUTTON_PIN, 0, BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW + 200);
+  runFor(BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW + 100);
+
+  TEST_ASSERT_TRUE(lamp->neoPixel.isSleepTimerActive());
+
+  uint32_t timerStartTime = sessionClock.getMillis();
+
+  runFor(NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS + 60000);
+
+  // Deep sleep once the fade is down, no later than one fade step after the timer ran out
+  TEST_ASSERT_TRUE(asleep);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS - BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW, stats.deepSleepTime - timerStartTime);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS + NEOPIXEL_DEFAULT_SLEEP_TIMER_MILLIS / 255 + 2, stats.deepSleepTime - timerStartTime);
+
+  // The playlist moved on while the lamp faded out, which is only in RTC memory since playlist switches skip NVS
+  Preferences preferences;
+
+  TEST_ASSERT_TRUE(stats.sleepPlaylistActive);
+  TEST_ASSERT_NOT_EQUAL(preferences.getUChar("mode", 0), (uint8_t) stats.sleepMode);
+
+  // The mode button wakes it up where it left off, without reading NVS
+  uint32_t preferencesReads = Host::preferencesReads;
+
+  bootLamp(ESP_SLEEP_WAKEUP_EXT0);
+
+  TEST_ASSERT_EQUAL_UINT32(preferencesReads, Host::preferencesReads);
+
+  runFor(1000);
+
+  TEST_ASSERT_EQUAL_UINT8((uint8_t) stats.sleepMode, (uint8_t) lamp->neoPixel.getMode());
+  TEST_ASSERT_TRUE(lamp->neoPixel.isPlaylistActive());
+  TEST_ASSERT_FALSE(lamp->neoPixel.isSleepTimerActive());
+}
+
+void test_day() {
+  SessionStats before = stats;
+  uint32_t allocationsBefore = allocations;
+  uint32_t startTime = sessionClock.getMillis();
+  uint16_t visitIndex = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint8_t hour = 0; hour < 24; hour++) {
+    if (hour == SESSION_SLEEP_HOUR) {
+      press(BRIGHTNESS_BUTTON_PIN, 0, BRIGHTNESS_BUTTON_LONG_TRIGGER_WINDOW + 200);
+    }
+
+    if (hour == SESSION_WAKE_HOUR) {
+      TEST_ASSERT_TRUE(asleep);
+      bootLamp(ESP_SLEEP_WAKEUP_EXT0);
+    }
+
+    if (hour >= SESSION_SLEEP_HOUR && hour < SESSION_WAKE_HOUR) {
+      runFor(SESSION_HOUR_MILLIS);
+      continue;
+    }
+
+    for (uint8_t i = 0; i < SESSION_HOUR_MILLIS / SESSION_VISIT_MILLIS; i++) {
+      visit(visitIndex++);
+    }
+  }
+
+  collectStats();
+
+  uint64_t elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  uint32_t virtualMillis = sessionClock.getMillis() - startTime;
+  uint32_t modeTriggers = stats.modeEvents[(uint8_t) DigitalInputEvent::Trigger];
+  uint32_t brightnessTriggers = stats.brightnessEvents[(uint8_t) DigitalInputEvent::Trigger];
+
+  TEST_ASSERT_EQUAL_UINT32(SESSION_DAY_MILLIS, sessionClock.getMillis() - startTime);
+
+  // Every press lands exactly once, no bounce or glitch gets through and nothing is dropped
+  TEST_ASSERT_EQUAL_UINT32(stats.modePresses, modeTriggers);
+  TEST_ASSERT_EQUAL_UINT32(stats.modePresses, stats.modeEvents[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_EQUAL_UINT32(stats.brightnessPresses, brightnessTriggers);
+  TEST_ASSERT_EQUAL_UINT32(stats.brightnessPresses, stats.brightnessEvents[(uint8_t) DigitalInputEvent::Release]);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.digitalInput.droppedEdges);
+
+  // The input tasks only wake once a transition has settled or a long trigger is due, never for a bounce or a glitch
+  uint32_t longTriggers = stats.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger] + stats.brightnessEvents[(uint8_t) DigitalInputEvent::LongTrigger];
+  uint32_t releases = stats.modeEvents[(uint8_t) DigitalInputEvent::Release] + stats.brightnessEvents[(uint8_t) DigitalInputEvent::Release];
+
+  TEST_ASSERT_EQUAL_UINT32(modeTriggers + brightnessTriggers + releases + longTriggers, stats.digitalInput.wakeups);
+  TEST_ASSERT_EQUAL_UINT32(modeTriggers + brightnessTriggers + releases, stats.digitalInput.latencySamples);
+  TEST_ASSERT_EQUAL_UINT32(before.boots + 1, stats.boots);
+  TEST_ASSERT_GREATER_THAN_UINT32(before.frames.frames, stats.frames.frames);
+
+  // Handlers, gestures, rendering and the wake up boot all run without touching the heap
+  TEST_ASSERT_EQUAL_UINT32(allocationsBefore, allocations);
+
+  // The day's speed, the counts below are for the whole run with the window tests before it
+  report("%u.%u virtual hours in %u ms, %u times real time",
+    virtualMillis / SESSION_HOUR_MILLIS,
+    virtualMillis % SESSION_HOUR_MILLIS * 10 / SESSION_HOUR_MILLIS,
+    (uint32_t) (elapsedMicros / 1000),
+    (uint32_t) (virtualMillis * 1000ULL / max(elapsedMicros, (uint64_t) 1)));
+  report("Mode button: %u presses, %u triggers, %u releases, %u long triggers",
+    stats.modePresses,
+    modeTriggers,
+    stats.modeEvents[(uint8_t) DigitalInputEvent::Release],
+    stats.modeEvents[(uint8_t) DigitalInputEvent::LongTrigger]);
+  report("Brightness button: %u presses, %u triggers, %u releases, %u long triggers",
+    stats.brightnessPresses,
+    brightnessTriggers,
+    stats.brightnessEvents[(uint8_t) DigitalInputEvent::Release],
+    stats.brightnessEvents[(uint8_t) DigitalInputEvent::LongTrigger]);
+  report("Buttons: %u edges, %u dropped, %u task wakeups, latency avg %u ms max %u ms",
+    stats.digitalInput.edges,
+    stats.digitalInput.droppedEdges,
+    stats.digitalInput.wakeups,
+    stats.digitalInput.latencySamples > 0 ? stats.digitalInput.totalLatency / stats.digitalInput.latencySamples : 0,
+    stats.digitalInput.maxLatency);
+  report("Gestures: %u speculations, %u cancellations, %u confirmations, decision max %u ms",
+    stats.gestures.speculations,
+    stats.gestures.cancellations,
+    stats.gestures.confirmations,
+    stats.gestures.maxDecisionMillis);
+  report("Knobs: %u events from %llu samples",
+    stats.analogEvents,
+    (unsigned long long) stats.samples);
+  report("Render: %u frames, %u steps, %u ms rendering, max %u us per frame",
+    stats.frames.frames,
+    stats.frames.steps,
+    (uint32_t) (stats.frames.totalRenderMicros / 1000),
+    stats.maxRenderMicros);
+  report("Power: %u boots, %u deep sleeps, %u light sleeps",
+    stats.boots,
+    Host::deepSleeps,
+    Host::lightSleeps);
+  report("Heap: %u allocations during the day, %u before it",
+    allocations - allocationsBefore,
+    allocationsBefore);
+}
+
+int main() {
+  Host::setMillisSource(getSessionMillis);
+  Host::setAnalogNoise(SESSION_ANALOG_NOISE);
+
+  for (uint8_t i = 0; i < SESSION_KNOB_COUNT; i++) {
+    Host::setAnalogLevel(KNOB_PINS[i], 2048);
+    sweep(i, 2048, 1);
+  }
+
+  bootLamp(ESP_SLEEP_WAKEUP_UNDEFINED);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+  RUN_TEST(test_bounce_is_one_press);
+  RUN_TEST(test_long_trigger_window);
+  RUN_TEST(test_gap_window);
+  RUN_TEST(test_still_knob_raises_nothing);
+  RUN_TEST(test_long_press_across_millis_wrap);
+  RUN_TEST(test_sleep_timer_and_wake);
+  RUN_TEST(test_day);
+  return UNITY_END();
+}
\ No newline at end of file
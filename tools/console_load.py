@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Load generator for the serial console.
+
+Writes bursts of console commands back to back to a serial port (or a pty when
+trying it on a desktop), waits for every reply of a burst and reports the round
+trip times, the throughput and the device's own stats from before and after the
+run. Every command changes the value it sets, so each burst ends up timed by the
+console's command to frame latency.
+
+    python3 tools/console_load.py /dev/ttyUSB0 --bursts 200 --burst-size 8
+
+Uses pyserial when it is installed, which PlatformIO already brings along, and
+falls back to termios for a plain device path otherwise.
+"""
+
+import argparse
+import os
+import random
+import re
+import select
+import statistics
+import sys
+import time
+
+MAX_MODE = 11
+PALETTE = ("red", "green", "blue", "white", "warm", "cool", "purple")
+STATS_PATTERN = re.compile(r"([a-z_]+) (\d+)")
+
+
+class TermiosPort:
+    def __init__(self, path, baud):
+        import termios
+        import tty
+
+        self._fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        tty.setraw(self._fd)
+
+        attributes = termios.tcgetattr(self._fd)
+        speed = getattr(termios, "B%d" % baud)
+        attributes[4] = attributes[5] = speed
+        termios.tcsetattr(self._fd, termios.TCSANOW, attributes)
+
+    def close(self):
+        os.close(self._fd)
+
+    def read(self, timeout):
+        readable, _, _ = select.select([self._fd], [], [], timeout)
+
+        if not readable:
+            return b""
+
+        try:
+            return os.read(self._fd, 4096)
+        except BlockingIOError:
+            return b""
+
+    def write(self, data):
+        while data:
+            _, writable, _ = select.select([], [self._fd], [])
+
+            if writable:
+                data = data[os.write(self._fd, data):]
+
+
+class PySerialPort:
+    def __init__(self, url, baud):
+        import serial
+
+        self._serial = serial.serial_for_url(url, baudrate=baud, timeout=0)
+
+    def close(self):
+        self._serial.close()
+
+    def read(self, timeout):
+        deadline = time.monotonic() + timeout
+
+        while True:
+            data = self._serial.read(max(1, self._serial.in_waiting))
+
+            if data or time.monotonic() >= deadline:
+                return data
+
+            time.sleep(0.001)
+
+    def write(self, data):
+        self._serial.write(data)
+        self._serial.flush()
+
+
+def open_port(url, baud):
+    try:
+        return PySerialPort(url, baud)
+    except ImportError:
+        return TermiosPort(url, baud)
+
+
+class Console:
+    def __init__(self, port, timeout):
+        self._buffer = b""
+        self._port = port
+        self._timeout = timeout
+
+    def read_line(self):
+        deadline = time.monotonic() + self._timeout
+
+        while b"\n" not in self._buffer:
+            remaining = deadline - time.monotonic()
+
+            if remaining <= 0:
+                return None
+
+            self._buffer += self._port.read(remaining)
+
+        line, self._buffer = self._buffer.split(b"\n", 1)
+        return line.decode("ascii", "replace").strip()
+
+    def read_replies(self, count, lines=None):
+        # Log output from the device is interleaved with the replies, only ok and error lines are counted
+        replies = []
+
+        while len(replies) < count:
+            line = self.read_line()
+
+            if line is None:
+                break
+
+            if line.startswith("ok") or line.startswith("error"):
+                replies.append(line)
+            elif lines is not None:
+                lines.append(line)
+
+        return replies
+
+    def send(self, commands):
+        self._port.write("".join(command + "\n" for command in commands).encode("ascii"))
+
+    def stats(self):
+        lines = []
+
+        self.send(["stats"])
+
+        if not self.read_replies(1, lines):
+            return None
+
+        stats = {}
+
+        for line in lines:
+            stats.update((name, int(value)) for name, value in STATS_PATTERN.findall(line))
+
+        return stats
+
+
+class CommandGenerator:
+    def __init__(self, seed):
+        self._brightness = 0
+        self._color = None
+        self._mode = 0
+        self._palette = None
+        self._random = random.Random(seed)
+
+    def next(self):
+        kind = self._random.choice(("brightness", "color", "mode", "palette"))
+
+        if kind == "brightness":
+            self._brightness = self._pick(range(1, 256), self._brightness)
+            return "brightness %d" % self._brightness
+
+        if kind == "color":
+            self._color = self._pick([tuple(self._random.randrange(256) for _ in range(3)) for _ in range(2)], self._color)
+            self._palette = None
+            return "color %d %d %d" % self._color
+
+        if kind == "mode":
+            self._mode = self._pick(range(1, MAX_MODE + 1), self._mode)
+            return "mode %d" % self._mode
+
+        self._color = None
+        self._palette = self._pick(PALETTE, self._palette)
+        return "palette %s" % self._palette
+
+    def _pick(self, choices, current):
+        return self._random.choice([choice for choice in choices if choice != current])
+
+
+def delta(before, after, name):
+    if before is None or after is None or name not in after:
+        return None
+
+    return after[name] - before.get(name, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Sends bursts of commands to the serial console and reports how it kept up")
+    parser.add_argument("port", help="serial port, pty or pyserial URL")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--bursts", type=int, default=100)
+    parser.add_argument("--burst-size", type=int, default=8, help="commands written back to back in one burst")
+    parser.add_argument("--interval", type=float, default=50, help="milliseconds between the end of one burst and the next")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--timeout", type=float, default=2, help="seconds to wait for a reply")
+    args = parser.parse_args()
+
+    port = open_port(args.port, args.baud)
+    console = Console(port, args.timeout)
+    generator = CommandGenerator(args.seed)
+
+    before = console.stats()
+
+    round_trips = []
+    sent_bytes = 0
+    errors = 0
+    lost = 0
+    start = time.monotonic()
+
+    for _ in range(args.bursts):
+        commands = [generator.next() for _ in range(args.burst_size)]
+        sent_bytes += sum(len(command) + 1 for command in commands)
+
+        burst_start = time.monotonic()
+        console.send(commands)
+        replies = console.read_replies(len(commands))
+        round_trips.append((time.monotonic() - burst_start) * 1000)
+
+        errors += sum(1 for reply in replies if reply.startswith("error"))
+        lost += len(commands) - len(replies)
+
+        time.sleep(args.interval / 1000)
+
+    elapsed = time.monotonic() - start
+    after = console.stats()
+    port.close()
+
+    commands = args.bursts * args.burst_size
+
+    print("commands %d bursts %d errors %d lost %d" % (commands, args.bursts, errors, lost))
+    print("burst_round_trip_avg_ms %.1f burst_round_trip_max_ms %.1f" % (statistics.mean(round_trips), max(round_trips)))
+    print("throughput_commands_per_s %.0f throughput_bytes_per_s %.0f" % (commands / elapsed, sent_bytes / elapsed))
+
+    if after is None:
+        print("no stats from the device", file=sys.stderr)
+        return 1
+
+    # The device counted the stats command that fetched these as well
+    device_commands = delta(before, after, "commands")
+
+    print("device_commands %s device_errors %s device_overflows %s" % (
+        device_commands - 1 if device_commands is not None else None,
+        delta(before, after, "errors"),
+        delta(before, after, "overflows")))
+
+    # Averages and maxima are since boot, the console has no command to reset them
+    print("device_latency_avg_us %s device_latency_max_us %s render_max_us %s late_max_us %s" % (
+        after.get("latency_avg_us"),
+        after.get("latency_max_us"),
+        after.get("render_max_us"),
+        after.get("late_max_us")))
+
+    return 0 if errors == 0 and lost == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
\ No newline at end of file